@@ -0,0 +1,262 @@
+#include "Bitboard.h"
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#if defined(CHESS_HAS_PEXT)
+#include <cpuid.h>
+#endif
+
+namespace {
+
+constexpr int KNIGHT_STEPS[8][2] = {{1, 2},  {1, -2},  {2, 1},  {2, -1},
+                                    {-1, 2}, {-1, -2}, {-2, 1}, {-2, -1}};
+constexpr int KING_STEPS[8][2] = {{-1, -1}, {-1, 0}, {-1, 1}, {0, -1},
+                                  {0, 1},   {1, -1}, {1, 0},  {1, 1}};
+constexpr int PAWN_STEPS[2][2][2] = {{{-1, 1}, {1, 1}}, {{-1, -1}, {1, -1}}};
+
+constexpr bool onBoard(int x, int y) {
+    return x >= 0 && x < 8 && y >= 0 && y < 8;
+}
+
+constexpr std::array<Bitboard, 64> makeStepTable(const int steps[][2],
+                                                 int count) {
+    std::array<Bitboard, 64> table{};
+    for (int square = 0; square < 64; ++square) {
+        for (int i = 0; i < count; ++i) {
+            int x = fileOf(square) + steps[i][0];
+            int y = rankOf(square) + steps[i][1];
+            if (onBoard(x, y)) {
+                table[square] |= squareBB(makeSquare(x, y));
+            }
+        }
+    }
+    return table;
+}
+
+// Squares after square in direction (dx, dy), up to the board edge or stop,
+// whichever comes first. stop itself is left out.
+constexpr Bitboard ray(int square, int dx, int dy, int stop) {
+    Bitboard squares = 0;
+    int x = fileOf(square) + dx;
+    int y = rankOf(square) + dy;
+    while (onBoard(x, y) && makeSquare(x, y) != stop) {
+        squares |= squareBB(makeSquare(x, y));
+        x += dx;
+        y += dy;
+    }
+    return squares;
+}
+
+constexpr int sign(int value) {
+    return (value > 0) - (value < 0);
+}
+
+constexpr std::array<std::array<Bitboard, 64>, 64> makeLineTable(
+    bool wholeLine) {
+    std::array<std::array<Bitboard, 64>, 64> table{};
+    for (int from = 0; from < 64; ++from) {
+        for (int to = 0; to < 64; ++to) {
+            int fileDistance = fileOf(to) - fileOf(from);
+            int rankDistance = rankOf(to) - rankOf(from);
+            bool aligned = fileDistance == 0 || rankDistance == 0 ||
+                           fileDistance == rankDistance ||
+                           fileDistance == -rankDistance;
+            if (from == to || !aligned) {
+                continue;
+            }
+            int dx = sign(fileDistance);
+            int dy = sign(rankDistance);
+            table[from][to] = wholeLine ? ray(from, dx, dy, -1) |
+                                              ray(from, -dx, -dy, -1) |
+                                              squareBB(from)
+                                        : ray(from, dx, dy, to);
+        }
+    }
+    return table;
+}
+
+}  // namespace
+
+constexpr std::array<Bitboard, 64> knightAttackTable =
+    makeStepTable(KNIGHT_STEPS, 8);
+constexpr std::array<Bitboard, 64> kingAttackTable =
+    makeStepTable(KING_STEPS, 8);
+constexpr std::array<std::array<Bitboard, 64>, 2> pawnAttackTable = {
+    makeStepTable(PAWN_STEPS[WHITE], 2), makeStepTable(PAWN_STEPS[BLACK], 2)};
+constexpr std::array<std::array<Bitboard, 64>, 64> betweenTable =
+    makeLineTable(false);
+constexpr std::array<std::array<Bitboard, 64>, 64> lineTable =
+    makeLineTable(true);
+
+// a1 = 0, b3 = 17, c2 = 10, e4 = 28, h8 = 63
+static_assert(knightAttackTable[0] == (squareBB(17) | squareBB(10)));
+static_assert(kingAttackTable[63] == (squareBB(62) | squareBB(54) |
+                                      squareBB(55)));
+static_assert(pawnAttackTable[WHITE][28] == (squareBB(35) | squareBB(37)));
+static_assert(pawnAttackTable[BLACK][28] == (squareBB(19) | squareBB(21)));
+static_assert(pawnAttackTable[WHITE][56] == 0 &&
+              pawnAttackTable[BLACK][7] == 0);
+static_assert(betweenTable[0][63] == 0x0040201008040200ULL);
+static_assert(betweenTable[0][17] == 0 && betweenTable[0][1] == 0);
+static_assert(lineTable[9][18] == 0x8040201008040201ULL);
+static_assert(lineTable[0][7] == lineTable[5][2] && lineTable[0][7] == 0xFF);
+
+Magic rookMagics[64];
+Magic bishopMagics[64];
+bool usePext = false;
+
+namespace {
+
+Bitboard rookTable[0x19000];
+Bitboard bishopTable[0x1480];
+
+const int ROOK_DIRECTIONS[4][2] = {{1, 0}, {-1, 0}, {0, 1}, {0, -1}};
+const int BISHOP_DIRECTIONS[4][2] = {{1, 1}, {1, -1}, {-1, 1}, {-1, -1}};
+
+// Walks each ray until it leaves the board or hits a blocker. Only used to
+// fill the tables.
+Bitboard slidingAttacks(int square,
+                        Bitboard occupied,
+                        const int directions[4][2]) {
+    Bitboard attacks = 0;
+    for (int i = 0; i < 4; ++i) {
+        int x = fileOf(square) + directions[i][0];
+        int y = rankOf(square) + directions[i][1];
+        while (x >= 0 && x < 8 && y >= 0 && y < 8) {
+            attacks |= squareBB(makeSquare(x, y));
+            if (occupied & squareBB(makeSquare(x, y))) {
+                break;
+            }
+            x += directions[i][0];
+            y += directions[i][1];
+        }
+    }
+    return attacks;
+}
+
+// Squares whose occupancy matters: the rays without the board edge.
+Bitboard relevantMask(int square, const int directions[4][2]) {
+    Bitboard mask = 0;
+    for (int i = 0; i < 4; ++i) {
+        int x = fileOf(square) + directions[i][0];
+        int y = rankOf(square) + directions[i][1];
+        int nextX = x + directions[i][0];
+        int nextY = y + directions[i][1];
+        while (nextX >= 0 && nextX < 8 && nextY >= 0 && nextY < 8) {
+            mask |= squareBB(makeSquare(x, y));
+            x = nextX;
+            y = nextY;
+            nextX += directions[i][0];
+            nextY += directions[i][1];
+        }
+    }
+    return mask;
+}
+
+// Per-rank seeds known to find every magic within a few thousand tries
+const uint64_t MAGIC_SEEDS[8] = {728, 10316, 55013, 32803,
+                                 12281, 15100, 16645, 255};
+
+uint64_t randomState = 0;
+
+uint64_t nextRandom() {
+    randomState ^= randomState >> 12;
+    randomState ^= randomState << 25;
+    randomState ^= randomState >> 27;
+    return randomState * 0x2545F4914F6CDD1DULL;
+}
+
+// Magics work best with few set bits
+uint64_t sparseRandom() {
+    return nextRandom() & nextRandom() & nextRandom();
+}
+
+void initMagics(Magic magics[64],
+                Bitboard* table,
+                const int directions[4][2]) {
+    std::vector<Bitboard> occupancies, attacks;
+    std::vector<int> epoch(4096, 0);
+    int attempt = 0;
+    Bitboard* nextSlot = table;
+
+    for (int square = 0; square < 64; ++square) {
+        Magic& m = magics[square];
+        m.mask = relevantMask(square, directions);
+        m.shift = 64 - popCount(m.mask);
+        m.attacks = nextSlot;
+        nextSlot += size_t(1) << popCount(m.mask);
+
+        // Carry-Rippler enumeration of every subset of the mask
+        occupancies.clear();
+        attacks.clear();
+        Bitboard subset = 0;
+        do {
+            occupancies.push_back(subset);
+            attacks.push_back(slidingAttacks(square, subset, directions));
+            subset = (subset - m.mask) & m.mask;
+        } while (subset);
+
+        if (usePext) {
+            for (size_t i = 0; i < occupancies.size(); ++i) {
+                m.attacks[m.index(occupancies[i])] = attacks[i];
+            }
+            continue;
+        }
+
+        // Try random candidates until one maps every subset without a
+        // destructive collision. epoch marks which slots this attempt wrote.
+        randomState = MAGIC_SEEDS[rankOf(square)];
+        bool found = false;
+        while (!found) {
+            do {
+                m.magic = sparseRandom();
+            } while (popCount((m.mask * m.magic) >> 56) < 6);
+
+            ++attempt;
+            found = true;
+            for (size_t i = 0; i < occupancies.size(); ++i) {
+                unsigned index = m.index(occupancies[i]);
+                if (epoch[index] < attempt) {
+                    epoch[index] = attempt;
+                    m.attacks[index] = attacks[i];
+                } else if (m.attacks[index] != attacks[i]) {
+                    found = false;
+                    break;
+                }
+            }
+        }
+    }
+}
+
+// Whether to look up slider attacks with PEXT. CHESS_NO_PEXT=1 (any value
+// but empty or 0) turns it off to compare the two. There is no check for
+// BMI2 itself: a BMI2 build may use it anywhere, so it could not run on a
+// CPU without it to begin with.
+bool cpuHasFastPext() {
+#if defined(CHESS_HAS_PEXT)
+    const char* disabled = std::getenv("CHESS_NO_PEXT");
+    if (disabled && *disabled && std::string(disabled) != "0") {
+        return false;
+    }
+    // AMD family 0x19 (Zen 3) is the first with PEXT in hardware
+    unsigned eax, ebx, ecx, edx;
+    if (__builtin_cpu_is("amd") && __get_cpuid(1, &eax, &ebx, &ecx, &edx)) {
+        const unsigned family = ((eax >> 8) & 0xf) + ((eax >> 20) & 0xff);
+        return family >= 0x19;
+    }
+    return true;
+#else
+    return false;
+#endif
+}
+
+struct MagicInit {
+    MagicInit() {
+        usePext = cpuHasFastPext();
+        initMagics(rookMagics, rookTable, ROOK_DIRECTIONS);
+        initMagics(bishopMagics, bishopTable, BISHOP_DIRECTIONS);
+    }
+} magicInit;
+
+}  // namespace
@@ -0,0 +1,121 @@
+#ifndef BITBOARD_H
+#define BITBOARD_H
+
+#include <array>
+#include <bit>
+#include <cstdint>
+#include "Piece.h"
+
+// PEXT is only compiled in when the whole build targets BMI2 (-mbmi2 or a
+// -march that has it), so that it inlines into every slider lookup
+#if defined(__BMI2__) && defined(__x86_64__)
+#include <immintrin.h>
+#define CHESS_HAS_PEXT
+#endif
+
+// One bit per square, a1 = bit 0, h1 = bit 7, a8 = bit 56.
+typedef uint64_t Bitboard;
+
+constexpr int makeSquare(int x, int y) {
+    return y * 8 + x;
+}
+
+constexpr int fileOf(int square) {
+    return square & 7;
+}
+
+constexpr int rankOf(int square) {
+    return square >> 3;
+}
+
+constexpr Bitboard squareBB(int square) {
+    return Bitboard(1) << square;
+}
+
+constexpr int popCount(Bitboard b) {
+    return std::popcount(b);
+}
+
+constexpr int lsb(Bitboard b) {
+    return std::countr_zero(b);
+}
+
+constexpr int popLsb(Bitboard& b) {
+    int square = lsb(b);
+    b &= b - 1;
+    return square;
+}
+
+// usePext is picked once at startup: PEXT in BMI2 builds on CPUs where it
+// is fast, magic multiplication everywhere else. AMD CPUs before Zen 3 run
+// PEXT in microcode, slower than the multiplication. Both index the same
+// per-square attack tables.
+extern bool usePext;
+
+// Per-square lookup for one slider type: the relevant occupancy mask and the
+// multiplier mapping each blocker subset to a slot in attacks.
+struct Magic {
+    Bitboard mask;
+    Bitboard magic;
+    Bitboard* attacks;
+    unsigned shift;
+
+    unsigned index(Bitboard occupied) const {
+#if defined(CHESS_HAS_PEXT)
+        if (usePext) {
+            return static_cast<unsigned>(_pext_u64(occupied, mask));
+        }
+#endif
+        return static_cast<unsigned>(((occupied & mask) * magic) >> shift);
+    }
+};
+
+extern Magic rookMagics[64];
+extern Magic bishopMagics[64];
+
+inline Bitboard rookAttacks(int square, Bitboard occupied) {
+    const Magic& m = rookMagics[square];
+    return m.attacks[m.index(occupied)];
+}
+
+inline Bitboard bishopAttacks(int square, Bitboard occupied) {
+    const Magic& m = bishopMagics[square];
+    return m.attacks[m.index(occupied)];
+}
+
+inline Bitboard queenAttacks(int square, Bitboard occupied) {
+    return rookAttacks(square, occupied) | bishopAttacks(square, occupied);
+}
+
+// Leaper attacks, built at compile time
+extern const std::array<Bitboard, 64> knightAttackTable;
+extern const std::array<Bitboard, 64> kingAttackTable;
+extern const std::array<std::array<Bitboard, 64>, 2> pawnAttackTable;
+
+inline Bitboard knightAttacks(int square) {
+    return knightAttackTable[square];
+}
+
+inline Bitboard kingAttacks(int square) {
+    return kingAttackTable[square];
+}
+
+inline Bitboard pawnAttacks(Color color, int square) {
+    return pawnAttackTable[color][square];
+}
+
+// Squares strictly between two squares on a shared rank, file or diagonal,
+// and the whole edge-to-edge line through them. Both are empty when the
+// squares are not aligned. Built at compile time.
+extern const std::array<std::array<Bitboard, 64>, 64> betweenTable;
+extern const std::array<std::array<Bitboard, 64>, 64> lineTable;
+
+inline Bitboard between(int from, int to) {
+    return betweenTable[from][to];
+}
+
+inline Bitboard line(int from, int to) {
+    return lineTable[from][to];
+}
+
+#endif  // BITBOARD_H
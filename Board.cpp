@@ -8,48 +8,42 @@
 #include <vector>
 #include "Minimax.h"
 #include "Move.h"
-
-Board::Board()
-    : squares(8, std::vector<std::shared_ptr<Piece>>(8, nullptr)),
-      enPassantTarget({-1, -1}),
-      whiteKingMoved(false),
-      blackKingMoved(false),
-      whiteRookMoved{false, false},
-      blackRookMoved{false, false},
-      halfmoveClock(0),
-      fullmoveNumber(1),
-      activeColor(WHITE) {
-    // Initialize the board with pieces
-    // Black pieces
-    squares[0][0] = std::make_shared<Rook>(WHITE);
-    squares[0][1] = std::make_shared<Knight>(WHITE);
-    squares[0][2] = std::make_shared<Bishop>(WHITE);
-    squares[0][3] = std::make_shared<Queen>(WHITE);
-    squares[0][4] = std::make_shared<King>(WHITE);
-    squares[0][5] = std::make_shared<Bishop>(WHITE);
-    squares[0][6] = std::make_shared<Knight>(WHITE);
-    squares[0][7] = std::make_shared<Rook>(WHITE);
-    for (int i = 0; i < 8; ++i) {
-        squares[1][i] = std::make_shared<Pawn>(WHITE);
+#include "MoveGen.h"
+#include "Zobrist.h"
+
+namespace {
+const std::string START_FEN =
+    "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1";
+
+#if defined(CHESS_DEBUG_HASH)
+// Built with -DCHESS_DEBUG_HASH=ON, every make and unmake recomputes the key
+// from scratch and stops at the first mismatch
+void verifyKey(const Board& board, const char* where) {
+    if (board.key != board.computeKey()) {
+        std::cerr << where << ": Zobrist key mismatch in " << board.toFEN()
+                  << std::endl;
+        std::abort();
     }
+}
+#endif
+}
 
-    // White pieces
-    squares[7][0] = std::make_shared<Rook>(BLACK);
-    squares[7][1] = std::make_shared<Knight>(BLACK);
-    squares[7][2] = std::make_shared<Bishop>(BLACK);
-    squares[7][3] = std::make_shared<Queen>(BLACK);
-    squares[7][4] = std::make_shared<King>(BLACK);
-    squares[7][5] = std::make_shared<Bishop>(BLACK);
-    squares[7][6] = std::make_shared<Knight>(BLACK);
-    squares[7][7] = std::make_shared<Rook>(BLACK);
-    for (int i = 0; i < 8; ++i) {
-        squares[6][i] = std::make_shared<Pawn>(BLACK);
-    }
+Board::Board() : Position(), halfmoveClock(0), fullmoveNumber(1) {
+    // Initialize the board with pieces
+    loadFEN(START_FEN);
 
     // Seed the random number generator
     // std::srand(std::time(0));
 }
 
+std::vector<std::vector<Piece>> Board::squares() const {
+    std::vector<std::vector<Piece>> grid(8, std::vector<Piece>(8, NO_PIECE));
+    for (int square = 0; square < 64; ++square) {
+        grid[rankOf(square)][fileOf(square)] = pieceOn(square);
+    }
+    return grid;
+}
+
 void Board::display() const {
     std::cout << "  ";
     for (int col = 0; col < 8; ++col) {
@@ -59,12 +53,8 @@ void Board::display() const {
 
     for (int row = 7; row >= 0; --row) {
         std::cout << row << ' ';
-        for (const auto& piece : squares[row]) {
-            if (piece) {
-                std::cout << piece->getSymbol() << ' ';
-            } else {
-                std::cout << ". ";
-            }
+        for (int col = 0; col < 8; ++col) {
+            std::cout << pieceSymbol(pieceAt(col, row)) << ' ';
         }
         std::cout << row << std::endl;
     }
@@ -77,211 +67,137 @@ void Board::display() const {
 }
 
 bool Board::makeMove(const Move& move) {
-    if (!squares[move.startY][move.startX]) {
+    const Piece piece = pieceOn(move.from());
+    if (piece == NO_PIECE) {
         return false;
     }
-
-    // add to history
-    history.push_back(HistoryItem(
-        enPassantTarget, whiteKingMoved, blackKingMoved, whiteRookMoved,
-        blackRookMoved, halfmoveClock, fullmoveNumber));
-
-    // Handle en passant
-    if (move.type == EN_PASSANT) {
-        squares[move.startY][move.endX] = nullptr;
-    }
-
-    if (move.type == NORMAL && move.piece->getSymbol() == 'P' &&
-        move.startY == 1 && move.endY == 3) {
-        enPassantTarget = {move.startX, 2};
-    } else if (move.type == NORMAL && move.piece->getSymbol() == 'p' &&
-               move.startY == 6 && move.endY == 4) {
-        enPassantTarget = {move.startX, 5};
+    if (pieceColor(piece) == WHITE) {
+        makeMove<WHITE>(move);
     } else {
-        enPassantTarget = {-1, -1};
+        makeMove<BLACK>(move);
     }
+    return true;
+}
 
-    // Handle castling
-    if (move.type == CASTLING) {
-        if (move.endX > move.startX) {
-            squares[move.endY][move.endX - 1] =
-                squares[move.endY][move.endX + 1];
-            squares[move.endY][move.endX + 1] = nullptr;
-            if (move.endY == 0) {
-                whiteRookMoved[1] = true;
-                whiteKingMoved = true;
-            } else {
-                blackRookMoved[1] = true;
-                blackKingMoved = true;
-            }
-        } else {
-            squares[move.endY][move.endX + 1] =
-                squares[move.endY][move.endX - 2];
-            squares[move.endY][move.endX - 2] = nullptr;
-            if (move.endY == 0) {
-                whiteRookMoved[0] = true;
-                whiteKingMoved = true;
-            } else {
-                blackRookMoved[0] = true;
-                blackKingMoved = true;
-            }
-        }
-    } else if (move.startY == 0 && move.startX == 4) {
-        whiteKingMoved = true;
-    } else if (move.startY == 7 && move.startX == 4) {
-        blackKingMoved = true;
-    } else if (move.startY == 0 && move.startX == 0) {
-        whiteRookMoved[0] = true;
-    } else if (move.startY == 0 && move.startX == 7) {
-        whiteRookMoved[1] = true;
-    } else if (move.startY == 7 && move.startX == 0) {
-        blackRookMoved[0] = true;
-    } else if (move.startY == 7 && move.startX == 7) {
-        blackRookMoved[1] = true;
-    }
+template <Color Us>
+void Board::makeMove(Move move) {
+    const bool pawnMove = pieces[makePiece(Us, PAWN)] & squareBB(move.from());
+    history.push({key, enPassantSquare, castlingRights,
+                  static_cast<uint16_t>(halfmoveClock), NO_PIECE});
+    const Piece captured = applyMove<Us>(move);
+    history.back().capturedPiece = captured;
 
-    // Handle promotion
-    if (move.type == PROMOTION) {
-        squares[move.endY][move.endX] = move.promotionPiece;
-    } else {
-        squares[move.endY][move.endX] = squares[move.startY][move.startX];
+    halfmoveClock = pawnMove || captured != NO_PIECE ? 0 : halfmoveClock + 1;
+    if (Us == BLACK) {
+        ++fullmoveNumber;
     }
+#if defined(CHESS_DEBUG_HASH)
+    verifyKey(*this, "makeMove");
+#endif
+}
 
-    // Update halfmove clock
-    if (squares[move.endY][move.endX]->getSymbol() == 'P' ||
-        squares[move.endY][move.endX]->getSymbol() == 'p' ||
-        squares[move.endY][move.endX]) {
-        halfmoveClock = 0;
+void Board::unmakeMove(const Move& move) {
+    if (occupancy[WHITE] & squareBB(move.to())) {
+        unmakeMove<WHITE>(move);
     } else {
-        ++halfmoveClock;
-    }
-
-    // Update fullmove number
-    if (activeColor == BLACK) {
-        ++fullmoveNumber;
+        unmakeMove<BLACK>(move);
     }
+}
 
-    // Switch active color
-    activeColor = (activeColor == WHITE) ? BLACK : WHITE;
+template <Color Us>
+void Board::unmakeMove(Move move) {
+    constexpr int Up = Us == WHITE ? 8 : -8;
+    const int from = move.from();
+    const int to = move.to();
+    const HistoryItem& previous = history.back();
 
-    squares[move.startY][move.startX] = nullptr;
-    return true;
-}
+    activeColor = Us;
 
-void Board::unmakeMove(const Move& move) {
-    squares[move.startY][move.startX] = squares[move.endY][move.endX];
-    squares[move.endY][move.endX] = move.capturedPiece;
+    // Handle promotion
+    if (move.type() == PROMOTION) {
+        removePiece(pieceOn(to), to);
+        putPiece(makePiece(Us, PAWN), from);
+    } else {
+        movePiece(pieceOn(to), to, from);
+    }
 
-    // Handle en passant
-    if (move.type == EN_PASSANT) {
-        squares[move.startY][move.endX] = std::make_shared<Pawn>(activeColor);
+    if (previous.capturedPiece != NO_PIECE) {
+        putPiece(previous.capturedPiece,
+                 move.type() == EN_PASSANT ? to - Up : to);
     }
 
     // Handle castling
-    if (move.type == CASTLING) {
-        if (move.endX > move.startX) {
-            squares[move.endY][move.endX + 1] =
-                squares[move.endY][move.endX - 1];
-            squares[move.endY][move.endX - 1] = nullptr;
+    if (move.type() == CASTLING) {
+        const Piece rook = makePiece(Us, ROOK);
+        if (to > from) {
+            movePiece(rook, to - 1, to + 1);
         } else {
-            squares[move.endY][move.endX - 2] =
-                squares[move.endY][move.endX + 1];
-            squares[move.endY][move.endX + 1] = nullptr;
+            movePiece(rook, to + 1, to - 2);
         }
     }
 
-    // Handle promotion
-    if (move.type == PROMOTION) {
-        squares[move.startY][move.startX] =
-            std::make_shared<Pawn>(activeColor == WHITE ? BLACK : WHITE);
-    }
-
-    // Switch active color back
-    activeColor = (activeColor == WHITE) ? BLACK : WHITE;
-
     // Restore history
-    enPassantTarget = history.back().enPassantTarget;
-    whiteKingMoved = history.back().whiteKingMoved;
-    blackKingMoved = history.back().blackKingMoved;
-    whiteRookMoved[0] = history.back().whiteRookMoved[0];
-    whiteRookMoved[1] = history.back().whiteRookMoved[1];
-    blackRookMoved[0] = history.back().blackRookMoved[0];
-    blackRookMoved[1] = history.back().blackRookMoved[1];
-    halfmoveClock = history.back().halfmoveClock;
-    fullmoveNumber = history.back().fullmoveNumber;
-    history.pop_back();
+    enPassantSquare = previous.enPassantSquare;
+    castlingRights = previous.castlingRights;
+    halfmoveClock = previous.halfmoveClock;
+    if (Us == BLACK) {
+        --fullmoveNumber;
+    }
+    key = previous.key;
+    history.pop();
+#if defined(CHESS_DEBUG_HASH)
+    verifyKey(*this, "unmakeMove");
+#endif
 }
 
 std::vector<Move> Board::generateAllMoves(Color color, bool legal) {
-    std::vector<Move> moves;
-    for (int startX = 0; startX < 8; ++startX) {
-        for (int startY = 0; startY < 8; ++startY) {
-            if (squares[startY][startX] &&
-                squares[startY][startX]->getColor() == color) {
-                auto validMoves = getValidMovesForSquare(startX, startY, legal);
-                moves.insert(moves.end(), validMoves.begin(), validMoves.end());
-            }
-        }
-    }
-    return moves;
+    MoveList moves;
+    generateAllMoves(color, legal, moves);
+    return std::vector<Move>(moves.begin(), moves.end());
 }
 
+template void Board::makeMove<WHITE>(Move);
+template void Board::makeMove<BLACK>(Move);
+template void Board::unmakeMove<WHITE>(Move);
+template void Board::unmakeMove<BLACK>(Move);
+
 std::vector<Move> Board::getValidMovesForSquare(int x, int y, bool legal) {
-    if (!squares[y][x]) {
+    const Piece piece = pieceAt(x, y);
+    if (piece == NO_PIECE) {
         return {};
     }
 
-    const Color color = squares[y][x]->getColor();
-    auto validMoves = squares[y][x]->generateValidMoves(x, y, this);
-    if (!legal) {
-        return validMoves;
-    }
-
-    std::vector<Move> filteredMoves;
-    for (const auto& move : validMoves) {
-        makeMove(move);
-        if (!isKingInCheck(color)) {
-            filteredMoves.push_back(move);
+    MoveList moves;
+    generateAllMoves(pieceColor(piece), legal, moves);
+    std::vector<Move> squareMoves;
+    for (const auto& move : moves) {
+        if (move.from() == makeSquare(x, y)) {
+            squareMoves.push_back(move);
         }
-        unmakeMove(move);
     }
-
-    return filteredMoves;
+    return squareMoves;
 }
 
-bool Board::isKingInCheck(Color color) const {
-    int kingX = -1, kingY = -1;
-    for (int row = 0; row < 8; ++row) {
-        for (int col = 0; col < 8; ++col) {
-            if (squares[row][col] && squares[row][col]->getSymbol() ==
-                                         (color == WHITE ? 'K' : 'k')) {
-                kingX = col;
-                kingY = row;
-                break;
-            }
+Move Board::moveFromUCI(const std::string& uci) {
+    MoveList moves;
+    generateAllMoves(activeColor, true, moves);
+    for (const auto& move : moves) {
+        if (move.toUCI() == uci) {
+            return move;
         }
-        if (kingX != -1)
-            break;
     }
-
-    for (int row = 0; row < 8; ++row) {
-        for (int col = 0; col < 8; ++col) {
-            if (squares[row][col] && squares[row][col]->getColor() != color) {
-                auto opponentMoves =
-                    squares[row][col]->generateValidMoves(col, row, this);
-                for (const auto& move : opponentMoves) {
-                    if (move.endX == kingX && move.endY == kingY) {
-                        return true;
-                    }
-                }
-            }
-        }
-    }
-    return false;
+    return Move();
 }
 
-bool Board::makeAIMove(Color color) {
-    Move bestMove = Minimax::findBestMove(*this, color, 3, true);
+bool Board::makeAIMove(Color color, int movetime, bool verbose) {
+    // Checkmate or stalemate: there is nothing to search
+    if (countLegalMoves(color) == 0) {
+        return false;
+    }
+    Minimax::SearchLimits limits;
+    limits.movetime = movetime;
+    Move bestMove =
+        Minimax::iterativeDeepening(*this, color, limits, verbose);
     return makeMove(bestMove);
 }
 
@@ -290,12 +206,12 @@ std::string Board::toFEN() const {
     for (int row = 7; row >= 0; --row) {
         int emptyCount = 0;
         for (int col = 0; col < 8; ++col) {
-            if (squares[row][col]) {
+            if (pieceAt(col, row) != NO_PIECE) {
                 if (emptyCount > 0) {
                     fen << emptyCount;
                     emptyCount = 0;
                 }
-                fen << squares[row][col]->getSymbol();
+                fen << pieceSymbol(pieceAt(col, row));
             } else {
                 ++emptyCount;
             }
@@ -313,26 +229,22 @@ std::string Board::toFEN() const {
 
     // Castling availability
     std::string castling = "";
-    if (!whiteKingMoved) {
-        if (!whiteRookMoved[1])
-            castling += "K";
-        if (!whiteRookMoved[0])
-            castling += "Q";
-    }
-    if (!blackKingMoved) {
-        if (!blackRookMoved[1])
-            castling += "k";
-        if (!blackRookMoved[0])
-            castling += "q";
-    }
+    if (castlingRights & WHITE_KINGSIDE)
+        castling += "K";
+    if (castlingRights & WHITE_QUEENSIDE)
+        castling += "Q";
+    if (castlingRights & BLACK_KINGSIDE)
+        castling += "k";
+    if (castlingRights & BLACK_QUEENSIDE)
+        castling += "q";
     if (castling.empty())
         castling = "-";
     fen << castling << " ";
 
     // En passant target square
-    if (enPassantTarget.first != -1 && enPassantTarget.second != -1) {
-        fen << static_cast<char>('a' + enPassantTarget.first)
-            << (enPassantTarget.second + 1);
+    if (enPassantSquare != -1) {
+        fen << static_cast<char>('a' + fileOf(enPassantSquare))
+            << (rankOf(enPassantSquare) + 1);
     } else {
         fen << "-";
     }
@@ -390,6 +302,14 @@ void Board::loadFEN(const std::string& fen) {
     }
 
     // Load pieces
+    for (int piece = 0; piece < 12; ++piece) {
+        pieces[piece] = 0;
+    }
+    occupancy[WHITE] = occupancy[BLACK] = 0;
+    middlegameScore = endgameScore = 0;
+    phase = 0;
+    history.clear();
+
     int row = 7;
     int col = 0;
     for (char c : tokens[0]) {
@@ -397,34 +317,11 @@ void Board::loadFEN(const std::string& fen) {
             --row;
             col = 0;
         } else if (isdigit(c)) {
-            int emptyCount = c - '0';
-            for (int i = 0; i < emptyCount; ++i) {
-                squares[row][col] = nullptr;
-                ++col;
-            }
+            col += c - '0';
         } else {
-            Color color = isupper(c) ? WHITE : BLACK;
-            switch (std::tolower(c)) {
-                case 'p':
-                    squares[row][col] = std::make_shared<Pawn>(color);
-                    break;
-                case 'r':
-                    squares[row][col] = std::make_shared<Rook>(color);
-                    break;
-                case 'n':
-                    squares[row][col] = std::make_shared<Knight>(color);
-                    break;
-                case 'b':
-                    squares[row][col] = std::make_shared<Bishop>(color);
-                    break;
-                case 'q':
-                    squares[row][col] = std::make_shared<Queen>(color);
-                    break;
-                case 'k':
-                    squares[row][col] = std::make_shared<King>(color);
-                    break;
-                default:
-                    break;
+            Piece piece = pieceFromSymbol(c);
+            if (piece != NO_PIECE) {
+                putPiece(piece, makeSquare(col, row));
             }
             ++col;
         }
@@ -434,25 +331,20 @@ void Board::loadFEN(const std::string& fen) {
     activeColor = (tokens[1] == "w") ? WHITE : BLACK;
 
     // Load castling availability
-    whiteKingMoved = false;
-    whiteRookMoved[0] = true;
-    whiteRookMoved[1] = true;
-    blackKingMoved = false;
-    blackRookMoved[0] = true;
-    blackRookMoved[1] = true;
+    castlingRights = 0;
     for (char c : tokens[2]) {
         switch (c) {
             case 'K':
-                whiteRookMoved[1] = false;
+                castlingRights |= WHITE_KINGSIDE;
                 break;
             case 'Q':
-                whiteRookMoved[0] = false;
+                castlingRights |= WHITE_QUEENSIDE;
                 break;
             case 'k':
-                blackRookMoved[1] = false;
+                castlingRights |= BLACK_KINGSIDE;
                 break;
             case 'q':
-                blackRookMoved[0] = false;
+                castlingRights |= BLACK_QUEENSIDE;
                 break;
             default:
                 break;
@@ -461,14 +353,14 @@ void Board::loadFEN(const std::string& fen) {
 
     // Load en passant target square
     if (tokens[3] != "-") {
-        enPassantTarget.first = tokens[3][0] - 'a';
-        enPassantTarget.second = tokens[3][1] - '1';
+        enPassantSquare = makeSquare(tokens[3][0] - 'a', tokens[3][1] - '1');
     } else {
-        enPassantTarget.first = -1;
-        enPassantTarget.second = -1;
+        enPassantSquare = -1;
     }
 
-    // Load halfmove clock and fullmove number
-    halfmoveClock = std::stoi(tokens[4]);
-    fullmoveNumber = std::stoi(tokens[5]);
+    // Load halfmove clock and fullmove number, which EPD-style FENs leave out
+    halfmoveClock = tokens.size() > 4 ? std::stoi(tokens[4]) : 0;
+    fullmoveNumber = tokens.size() > 5 ? std::stoi(tokens[5]) : 1;
+
+    key = computeKey();
 }
\ No newline at end of file
@@ -1,42 +1,61 @@
 #ifndef BOARD_H
 #define BOARD_H
 
-#include <memory>
 #include <string>
 #include <utility>
 #include <vector>
+#include "Bitboard.h"
 #include "HistoryItem.h"
 #include "Move.h"
+#include "MoveList.h"
 #include "Piece.h"
+#include "Position.h"
 
-class Minimax;
-
-class Board {
+// A Position with the moves that led to it, so they can be taken back, and
+// the conversions to and from text that the front ends use.
+class Board : public Position {
    public:
+    // Milliseconds the front ends give the engine per move
+    static const int AI_MOVETIME = 1000;
+
     Board();
     void display() const;
     bool makeMove(const Move& move);
     void unmakeMove(const Move& move);
     std::vector<Move> generateAllMoves(Color color, bool legal);
+    // Position's overloads append to a stack-allocated list instead; those
+    // are the ones the search and perft use, since they never touch the heap.
+    using Position::generateAllMoves;
+
+    // The same with the moving side fixed at compile time, so pawn
+    // directions and back ranks are constants. The overloads above look up
+    // the side and dispatch here.
+    template <Color Us>
+    void makeMove(Move move);
+    template <Color Us>
+    void unmakeMove(Move move);
+
     std::vector<Move> getValidMovesForSquare(int x, int y, bool legal);
-    bool makeAIMove(Color color);
+    // Plays the move the search picks for color within movetime
+    // milliseconds, printing its progress when verbose. False when color
+    // has no legal move.
+    bool makeAIMove(Color color,
+                    int movetime = AI_MOVETIME,
+                    bool verbose = false);
     std::string toFEN() const;
     void displayFEN() const;
     void loadFEN(const std::string& fen);
+    // Finds the legal move written in UCI notation, or the null move.
+    Move moveFromUCI(const std::string& uci);
+
+    // Slow compatibility view as a [y][x] grid of pieces. Rebuilt on every
+    // call; only the GUI should need it.
+    std::vector<std::vector<Piece>> squares() const;
 
-    std::vector<std::vector<std::shared_ptr<Piece>>> squares;
-    std::pair<int, int> enPassantTarget;
-    bool whiteKingMoved;
-    bool blackKingMoved;
-    bool whiteRookMoved[2];
-    bool blackRookMoved[2];
     int halfmoveClock;
     int fullmoveNumber;
-    Color activeColor;
-    std::vector<HistoryItem> history;
-
-   private:
-    bool isKingInCheck(Color color) const;
+    // One entry per move played since the position was loaded
+    UndoStack history;
 };
 
 #endif  // BOARD_H
\ No newline at end of file
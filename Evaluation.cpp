@@ -0,0 +1,427 @@
+#include "Evaluation.h"
+#include <cassert>
+#include <utility>
+#include "Bitboard.h"
+#include "PieceSquareTables.h"
+
+#if defined(__GNUC__) && defined(__x86_64__)
+#define EVALUATION_X86
+#endif
+
+namespace {
+
+// Value of a term in centipawns for each pawn or square it counts
+struct Weight {
+    int middlegame;
+    int endgame;
+};
+
+const Weight DOUBLED_PAWN = {-10, -25};
+const Weight ISOLATED_PAWN = {-12, -18};
+const Weight BACKWARD_PAWN = {-8, -12};
+// Indexed by the rank counted from the pawn's own side
+const Weight PASSED_PAWN[8] = {{0, 0},   {5, 10},  {10, 15}, {15, 25},
+                               {30, 45}, {50, 75}, {90, 120}, {0, 0}};
+// A passed pawn with a piece on the square in front of it
+const Weight BLOCKED_PASSED_PAWN = {-5, -15};
+const Weight KNIGHT_MOBILITY = {4, 4};
+const Weight BISHOP_MOBILITY = {5, 5};
+const Weight ROOK_MOBILITY = {2, 4};
+const Weight QUEEN_MOBILITY = {1, 2};
+
+const Bitboard FILE_A = 0x0101010101010101ULL;
+const Bitboard FILE_B = FILE_A << 1;
+const Bitboard FILE_G = FILE_A << 6;
+const Bitboard FILE_H = FILE_A << 7;
+const Bitboard RANK_1 = 0xffULL;
+
+// Everything below up to the kernels takes either a Bitboard or a vector
+// of them with one position per lane, so both paths run the same formulas.
+// The helpers are forced inline so that a kernel compiled for a wider
+// instruction set also compiles them for it; that also means no vector is
+// ever passed by the calling convention GCC warns about.
+#define EVALUATION_INLINE [[gnu::always_inline]] inline
+#if defined(__GNUC__)
+#pragma GCC diagnostic ignored "-Wpsabi"
+#endif
+
+// Shifts by Shift squares towards h8 (positive) or a1 (negative)
+template <int Shift, typename B>
+EVALUATION_INLINE B shift(const B& b) {
+    if constexpr (Shift > 0) {
+        return b << Shift;
+    } else {
+        return b >> -Shift;
+    }
+}
+
+template <typename B>
+EVALUATION_INLINE B shiftEast(const B& b) {
+    return (b << 1) & ~FILE_A;
+}
+
+template <typename B>
+EVALUATION_INLINE B shiftWest(const B& b) {
+    return (b >> 1) & ~FILE_H;
+}
+
+template <Color Us, typename B>
+EVALUATION_INLINE B forward(const B& b) {
+    return shift<Us == WHITE ? 8 : -8>(b);
+}
+
+// b and every square in front of it
+template <Color Us, typename B>
+EVALUATION_INLINE B forwardFill(const B& b) {
+    constexpr int Up = Us == WHITE ? 8 : -8;
+    B fill = b | shift<Up>(b);
+    fill |= shift<2 * Up>(fill);
+    return fill | shift<4 * Up>(fill);
+}
+
+template <Color Us, typename B>
+EVALUATION_INLINE B pawnAttackSet(const B& pawns) {
+    return shiftEast(forward<Us>(pawns)) | shiftWest(forward<Us>(pawns));
+}
+
+template <typename B>
+EVALUATION_INLINE B knightAttackSet(const B& knights) {
+    const B one = shiftEast(knights) | shiftWest(knights);
+    const B two = ((knights << 2) & ~(FILE_A | FILE_B)) |
+                  ((knights >> 2) & ~(FILE_G | FILE_H));
+    return (one << 16) | (one >> 16) | (two << 8) | (two >> 8);
+}
+
+// Squares the sliders reach in the direction of Shift, stopping at and
+// including the first occupied square. Each step doubles the distance
+// filled, so three cover the board.
+template <int Shift, typename B>
+EVALUATION_INLINE B slideAttackSet(const B& sliders, const B& empty) {
+    constexpr int File = (Shift % 8 + 8) % 8;
+    constexpr Bitboard Wrap = File == 1 ? ~FILE_A : File == 7 ? ~FILE_H : ~0ULL;
+    B reach = sliders;
+    B open = empty & Wrap;
+    reach |= open & shift<Shift>(reach);
+    open &= shift<Shift>(open);
+    reach |= open & shift<2 * Shift>(reach);
+    open &= shift<2 * Shift>(open);
+    reach |= open & shift<4 * Shift>(reach);
+    return shift<Shift>(reach) & Wrap;
+}
+
+template <typename B>
+EVALUATION_INLINE B diagonalAttackSet(const B& sliders, const B& empty) {
+    return slideAttackSet<9>(sliders, empty) |
+           slideAttackSet<7>(sliders, empty) |
+           slideAttackSet<-7>(sliders, empty) |
+           slideAttackSet<-9>(sliders, empty);
+}
+
+template <typename B>
+EVALUATION_INLINE B straightAttackSet(const B& sliders, const B& empty) {
+    return slideAttackSet<8>(sliders, empty) |
+           slideAttackSet<-8>(sliders, empty) |
+           slideAttackSet<1>(sliders, empty) |
+           slideAttackSet<-1>(sliders, empty);
+}
+
+EVALUATION_INLINE int count(Bitboard b) {
+    return popCount(b);
+}
+
+// Population count of every lane. There is no vector instruction for it
+// before AVX-512, so the bits are summed in ever wider fields.
+template <typename B>
+EVALUATION_INLINE B count(const B& squares) {
+    B b = squares - ((squares >> 1) & 0x5555555555555555ULL);
+    b = (b & 0x3333333333333333ULL) + ((b >> 2) & 0x3333333333333333ULL);
+    b = (b + (b >> 4)) & 0x0f0f0f0f0f0f0f0fULL;
+    b += b >> 8;
+    b += b >> 16;
+    b += b >> 32;
+    return b & 0x7f;
+}
+
+template <Color Us, typename S, typename B>
+EVALUATION_INLINE void addTerm(S& middlegame,
+                               S& endgame,
+                               const B& squares,
+                               Weight weight) {
+    constexpr int Sign = Us == WHITE ? 1 : -1;
+    const S n = (S)count(squares);
+    middlegame += n * (Sign * weight.middlegame);
+    endgame += n * (Sign * weight.endgame);
+}
+
+// The pawn structure terms of Us, which depend on nothing but the pawns.
+// Returns Us's passed pawns.
+template <Color Us, typename S, typename B>
+EVALUATION_INLINE B addPawnTerms(const B* pieces, S& middlegame, S& endgame) {
+    constexpr Color Them = Us == WHITE ? BLACK : WHITE;
+    const B pawns = pieces[Us == WHITE ? WHITE_PAWN : BLACK_PAWN];
+    const B theirPawns = pieces[Us == WHITE ? BLACK_PAWN : WHITE_PAWN];
+
+    // Pawns with an own pawn behind them on the same file
+    const B doubled = pawns & forwardFill<Us>(forward<Us>(pawns));
+    const B files = forwardFill<Us>(pawns) | forwardFill<Them>(pawns);
+    const B isolated = pawns & ~(shiftEast(files) | shiftWest(files));
+    // Pawns whose next square is attacked by an enemy pawn and can never
+    // be covered by an own pawn, since none are level or behind next door
+    const B ahead = forward<Us>(forwardFill<Us>(pawns));
+    const B covered = shiftEast(ahead) | shiftWest(ahead);
+    const B backward = forward<Them>(forward<Us>(pawns) &
+                                     pawnAttackSet<Them>(theirPawns) &
+                                     ~covered);
+    // Pawns no enemy pawn can stop or capture on the way to promotion
+    const B theirSpans = forwardFill<Them>(forward<Them>(theirPawns));
+    const B passed =
+        pawns & ~(theirSpans | shiftEast(theirSpans) | shiftWest(theirSpans));
+
+    addTerm<Us>(middlegame, endgame, doubled, DOUBLED_PAWN);
+    addTerm<Us>(middlegame, endgame, isolated, ISOLATED_PAWN);
+    addTerm<Us>(middlegame, endgame, backward, BACKWARD_PAWN);
+    for (int rank = 1; rank < 7; ++rank) {
+        const int shift = 8 * (Us == WHITE ? rank : 7 - rank);
+        addTerm<Us>(middlegame, endgame, passed & (RANK_1 << shift),
+                    PASSED_PAWN[rank]);
+    }
+    return passed;
+}
+
+// The terms of Us that depend on the other pieces too. reach holds the
+// squares Us's knights, bishops, rooks and queens attack, in that order,
+// and passed Us's passed pawns.
+template <Color Us, typename S, typename B>
+EVALUATION_INLINE void addPieceTerms(const B* pieces,
+                                     const B* occupancy,
+                                     const B* reach,
+                                     const B& passed,
+                                     S& middlegame,
+                                     S& endgame) {
+    constexpr Color Them = Us == WHITE ? BLACK : WHITE;
+    const B theirPawns = pieces[Us == WHITE ? BLACK_PAWN : WHITE_PAWN];
+    const B safe = ~(occupancy[Us] | pawnAttackSet<Them>(theirPawns));
+    addTerm<Us>(middlegame, endgame, reach[0] & safe, KNIGHT_MOBILITY);
+    addTerm<Us>(middlegame, endgame, reach[1] & safe, BISHOP_MOBILITY);
+    addTerm<Us>(middlegame, endgame, reach[2] & safe, ROOK_MOBILITY);
+    addTerm<Us>(middlegame, endgame, reach[3] & safe, QUEEN_MOBILITY);
+
+    const B occupied = occupancy[WHITE] | occupancy[BLACK];
+    addTerm<Us>(middlegame, endgame, passed & forward<Them>(occupied),
+                BLOCKED_PASSED_PAWN);
+}
+
+// The scalar reach comes from the attack tables the move generator uses,
+// one piece at a time, which beats the fills when there is one position
+template <Color Us>
+void addScalarPieceTerms(const Position& position,
+                         Bitboard passed,
+                         int& middlegame,
+                         int& endgame) {
+    const Bitboard occupied = position.allPieces();
+    Bitboard reach[4] = {};
+    for (Bitboard knights = position.pieces[makePiece(Us, KNIGHT)]; knights;) {
+        reach[0] |= knightAttacks(popLsb(knights));
+    }
+    for (Bitboard bishops = position.pieces[makePiece(Us, BISHOP)]; bishops;) {
+        reach[1] |= bishopAttacks(popLsb(bishops), occupied);
+    }
+    for (Bitboard rooks = position.pieces[makePiece(Us, ROOK)]; rooks;) {
+        reach[2] |= rookAttacks(popLsb(rooks), occupied);
+    }
+    for (Bitboard queens = position.pieces[makePiece(Us, QUEEN)]; queens;) {
+        reach[3] |= queenAttacks(popLsb(queens), occupied);
+    }
+    addPieceTerms<Us>(position.pieces, position.occupancy, reach, passed,
+                      middlegame, endgame);
+}
+
+// The pawn terms of position from the calling thread's pawn table, which
+// are computed and stored there when missing. Returned by value, as the
+// next probe may take the slot.
+PawnHashTable::Entry pawnTerms(const Position& position) {
+    bool found;
+    PawnHashTable::Entry& pawns =
+        Evaluation::pawnTable().probe(position, found);
+    if (!found) {
+        int middlegame = 0;
+        int endgame = 0;
+        pawns.passed =
+            addPawnTerms<WHITE>(position.pieces, middlegame, endgame) |
+            addPawnTerms<BLACK>(position.pieces, middlegame, endgame);
+        pawns.middlegame = static_cast<int16_t>(middlegame);
+        pawns.endgame = static_cast<int16_t>(endgame);
+    }
+    return pawns;
+}
+
+// The bitboard get reads from each item, one item per lane. The vector is
+// built from the values rather than stored to lane by lane, which would
+// leave its first read waiting on the stores.
+template <typename B, typename T, typename Get, size_t... Lane>
+EVALUATION_INLINE B gatherLanes(const T* items,
+                                Get get,
+                                std::index_sequence<Lane...>) {
+    return B{get(items[Lane])...};
+}
+
+// Evaluates as many positions as B has lanes. The pawn terms come from the
+// pawn table one position at a time, like in evaluate. The bitboards are
+// moved into structure-of-arrays form, one vector per piece, and the
+// sliders' reach is found with fills instead of table lookups, which have
+// no vector form.
+template <typename B, typename S>
+EVALUATION_INLINE void evaluateLanes(const Position* positions, int* scores) {
+    constexpr int LANES = sizeof(B) / sizeof(Bitboard);
+    const auto lanes = std::make_index_sequence<LANES>();
+    PawnHashTable::Entry pawns[LANES];
+    for (int lane = 0; lane < LANES; ++lane) {
+        pawns[lane] = pawnTerms(positions[lane]);
+    }
+    const B passed = gatherLanes<B>(
+        pawns, [](const PawnHashTable::Entry& e) { return e.passed; }, lanes);
+
+    B pieces[12];
+    for (int piece = 0; piece < 12; ++piece) {
+        pieces[piece] = gatherLanes<B>(
+            positions,
+            [piece](const Position& p) { return p.pieces[piece]; }, lanes);
+    }
+    B occupancy[2];
+    for (Color color : {WHITE, BLACK}) {
+        occupancy[color] = gatherLanes<B>(
+            positions,
+            [color](const Position& p) { return p.occupancy[color]; }, lanes);
+    }
+
+    const B empty = ~(occupancy[WHITE] | occupancy[BLACK]);
+    S middlegame = {};
+    S endgame = {};
+    for (Color color : {WHITE, BLACK}) {
+        const B* own = pieces + makePiece(color, PAWN);
+        const B reach[4] = {
+            knightAttackSet(own[KNIGHT]),
+            diagonalAttackSet(own[BISHOP], empty),
+            straightAttackSet(own[ROOK], empty),
+            diagonalAttackSet(own[QUEEN], empty) |
+                straightAttackSet(own[QUEEN], empty),
+        };
+        const B ownPassed = passed & own[PAWN];
+        if (color == WHITE) {
+            addPieceTerms<WHITE>(pieces, occupancy, reach, ownPassed,
+                                 middlegame, endgame);
+        } else {
+            addPieceTerms<BLACK>(pieces, occupancy, reach, ownPassed,
+                                 middlegame, endgame);
+        }
+    }
+
+    for (int lane = 0; lane < LANES; ++lane) {
+        const Position& position = positions[lane];
+        scores[lane] = taper(position.middlegameScore +
+                                 pawns[lane].middlegame + int(middlegame[lane]),
+                             position.endgameScore + pawns[lane].endgame +
+                                 int(endgame[lane]),
+                             position.phase);
+    }
+}
+
+#if defined(EVALUATION_X86)
+typedef Bitboard Bitboard4 __attribute__((vector_size(32)));
+typedef int64_t Score4 __attribute__((vector_size(32)));
+typedef Bitboard Bitboard8 __attribute__((vector_size(64)));
+typedef int64_t Score8 __attribute__((vector_size(64)));
+
+__attribute__((target("avx2"))) void evaluateAvx2(const Position* positions,
+                                                  int* scores) {
+    evaluateLanes<Bitboard4, Score4>(positions, scores);
+}
+
+__attribute__((target("avx512f"))) void evaluateAvx512(
+    const Position* positions,
+    int* scores) {
+    evaluateLanes<Bitboard8, Score8>(positions, scores);
+}
+#endif
+
+Evaluation::Kernel bestKernel() {
+    for (Evaluation::Kernel kernel : {Evaluation::AVX512, Evaluation::AVX2}) {
+        if (Evaluation::supports(kernel)) {
+            return kernel;
+        }
+    }
+    return Evaluation::SCALAR;
+}
+
+Evaluation::Kernel activeKernel = bestKernel();
+
+}  // namespace
+
+int Evaluation::evaluate(const Position& position) {
+#if defined(CHESS_DEBUG_EVAL)
+    // Checks the running piece-square totals against a recount
+    position.evaluate();
+#endif
+    const PawnHashTable::Entry pawns = pawnTerms(position);
+    int middlegame = position.middlegameScore + pawns.middlegame;
+    int endgame = position.endgameScore + pawns.endgame;
+    addScalarPieceTerms<WHITE>(position,
+                               pawns.passed & position.pieces[WHITE_PAWN],
+                               middlegame, endgame);
+    addScalarPieceTerms<BLACK>(position,
+                               pawns.passed & position.pieces[BLACK_PAWN],
+                               middlegame, endgame);
+    return taper(middlegame, endgame, position.phase);
+}
+
+PawnHashTable& Evaluation::pawnTable() {
+    thread_local PawnHashTable table;
+    return table;
+}
+
+void Evaluation::evaluateBatch(std::span<const Position> positions,
+                               std::span<int> scores) {
+    assert(scores.size() >= positions.size());
+    size_t i = 0;
+#if defined(EVALUATION_X86)
+    if (activeKernel == AVX512) {
+        for (; i + 8 <= positions.size(); i += 8) {
+            evaluateAvx512(&positions[i], &scores[i]);
+        }
+    } else if (activeKernel == AVX2) {
+        for (; i + 4 <= positions.size(); i += 4) {
+            evaluateAvx2(&positions[i], &scores[i]);
+        }
+    }
+#endif
+    for (; i < positions.size(); ++i) {
+        scores[i] = evaluate(positions[i]);
+    }
+}
+
+bool Evaluation::supports(Kernel kernel) {
+    switch (kernel) {
+#if defined(EVALUATION_X86)
+        case AVX512:
+            return __builtin_cpu_supports("avx512f");
+        case AVX2:
+            return __builtin_cpu_supports("avx2");
+#endif
+        case SCALAR:
+            return true;
+        default:
+            return false;
+    }
+}
+
+bool Evaluation::setKernel(Kernel kernel) {
+    if (!supports(kernel)) {
+        return false;
+    }
+    activeKernel = kernel;
+    return true;
+}
+
+Evaluation::Kernel Evaluation::kernel() {
+    return activeKernel;
+}
@@ -0,0 +1,42 @@
+#ifndef EVALUATION_H
+#define EVALUATION_H
+
+#include <span>
+#include "PawnHashTable.h"
+#include "Position.h"
+
+// The classical evaluation: the piece-square totals Position keeps up to
+// date, plus pawn structure (doubled, isolated, backward and passed pawns,
+// and passed pawns with a piece in the way) and mobility (the squares each
+// piece type reaches that are neither own pieces nor attacked by enemy
+// pawns, counted once per type).
+class Evaluation {
+   public:
+    // Score in centipawns from white's point of view. The pawn terms are
+    // looked up in pawnTable() and only computed when missing.
+    static int evaluate(const Position& position);
+    // The calling thread's cache of pawn terms. Each thread gets its own,
+    // so searches on different threads never contend for one.
+    static PawnHashTable& pawnTable();
+
+    // scores[i] = evaluate(positions[i]) for every position. The bitboards
+    // of 4 or 8 positions are laid out side by side and the mobility terms
+    // are computed for all of them with the same instructions, which pays
+    // off where there are many pieces; endgames run about as fast as one
+    // call each. scores must be at least as long.
+    static void evaluateBatch(std::span<const Position> positions,
+                              std::span<int> scores);
+
+    // Instruction sets evaluateBatch is written for, with the number of
+    // positions handled at once. The scalar one calls evaluate for each
+    // position; all give the same results.
+    enum Kernel { SCALAR, AVX2, AVX512 };
+
+    // The best kernel the CPU supports is picked at startup. This forces
+    // another one and fails if the CPU cannot run it.
+    static bool setKernel(Kernel kernel);
+    static Kernel kernel();
+    static bool supports(Kernel kernel);
+};
+
+#endif  // EVALUATION_H
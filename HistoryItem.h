@@ -1,30 +1,69 @@
-#include <utility>
+#ifndef HISTORYITEM_H
+#define HISTORYITEM_H
 
-class HistoryItem {
+#include <cstdint>
+#include <vector>
+#include "Piece.h"
+
+// What a move destroys and unmakeMove cannot work out from the position
+// after it. The fullmove number is not kept; it only ever goes up by one
+// after a black move.
+struct HistoryItem {
+    uint64_t key;
+    int8_t enPassantSquare;  // -1 when there was no en passant target
+    uint8_t castlingRights;  // CastlingRight bits
+    uint16_t halfmoveClock;
+    Piece capturedPiece;  // NO_PIECE if the move captured nothing
+};
+
+static_assert(sizeof(HistoryItem) <= 16, "HistoryItem must fit in 16 bytes");
+
+// Stack of HistoryItems, one per ply played since the position was loaded.
+// Like MoveList the first CAPACITY items live inline and never touch the
+// heap, so making and unmaking moves cannot reallocate in the middle of a
+// search. Only a game longer than that spills onto the heap.
+class UndoStack {
    public:
-    HistoryItem(const std::pair<int, int>& enPassantTarget,
-                bool whiteKingMoved,
-                bool blackKingMoved,
-                bool whiteRookMoved[2],
-                bool blackRookMoved[2],
-                int halfmoveClock,
-                int fullmoveNumber)
-        : enPassantTarget(enPassantTarget),
-          whiteKingMoved(whiteKingMoved),
-          blackKingMoved(blackKingMoved),
-          halfmoveClock(halfmoveClock),
-          fullmoveNumber(fullmoveNumber) {
-        this->whiteRookMoved[0] = whiteRookMoved[0];
-        this->whiteRookMoved[1] = whiteRookMoved[1];
-        this->blackRookMoved[0] = blackRookMoved[0];
-        this->blackRookMoved[1] = blackRookMoved[1];
-    };
-
-    std::pair<int, int> enPassantTarget;
-    bool whiteKingMoved;
-    bool blackKingMoved;
-    bool whiteRookMoved[2];
-    bool blackRookMoved[2];
-    int halfmoveClock;
-    int fullmoveNumber;
-};
\ No newline at end of file
+    // Far longer than any real game
+    static const int CAPACITY = 1024;
+
+    UndoStack() : count(0) {}
+
+    void push(const HistoryItem& item) {
+        if (count < CAPACITY) {
+            items[count] = item;
+        } else {
+            overflow.push_back(item);
+        }
+        ++count;
+    }
+    void pop() {
+        if (count > CAPACITY) {
+            overflow.pop_back();
+        }
+        --count;
+    }
+    void clear() {
+        count = 0;
+        overflow.clear();
+    }
+
+    HistoryItem& back() { return at(count - 1); }
+    const HistoryItem& back() const { return (*this)[count - 1]; }
+    const HistoryItem& operator[](int ply) const {
+        return ply < CAPACITY ? items[ply] : overflow[ply - CAPACITY];
+    }
+    int size() const { return count; }
+    bool empty() const { return count == 0; }
+
+   private:
+    HistoryItem& at(int ply) {
+        return ply < CAPACITY ? items[ply] : overflow[ply - CAPACITY];
+    }
+
+    HistoryItem items[CAPACITY];
+    std::vector<HistoryItem> overflow;
+    int count;
+};
+
+#endif  // HISTORYITEM_H
@@ -1,161 +1,416 @@
 #include "Minimax.h"
+#include <algorithm>
+#include <cassert>
+#include <iostream>
 #include <limits>
-#include "Board.h"
+#include "Evaluation.h"
 #include "Move.h"
+#include "MovePicker.h"
 
-Move Minimax::findBestMove(Board& board,
+namespace {
+
+using Clock = std::chrono::steady_clock;
+using Milliseconds = std::chrono::milliseconds;
+
+// Symmetric around zero so a score can always be negated
+const int INFINITE_SCORE = std::numeric_limits<int>::max();
+// The score of a node whose side to move has lost its king, less the ply
+// it was lost at so the sooner the better. Beyond any network output.
+const int KING_CAPTURED_SCORE = INFINITE_SCORE / 2;
+// Nodes between two looks at the clock
+const unsigned long long TIME_CHECK_INTERVAL = 2048;
+// Kept back from the clock for the time it takes to get the move out
+const int MOVE_OVERHEAD = 30;
+
+// The times after which no new iteration is started (soft) and at which
+// the search is stopped (hard). An iteration usually takes a few times as
+// long as the one before, so one started past half the hard limit would
+// rarely finish.
+void allocateTime(const Minimax::SearchLimits& limits,
+                  Color color,
+                  Milliseconds& soft,
+                  Milliseconds& hard) {
+    if (limits.movetime > 0) {
+        hard = Milliseconds(limits.movetime);
+        soft = hard / 2;
+    } else if (limits.time[color] > 0) {
+        const int left = std::max(limits.time[color] - MOVE_OVERHEAD, 1);
+        const int movesToGo = limits.movesToGo > 0 ? limits.movesToGo : 30;
+        const int share = left / movesToGo + limits.increment[color] * 3 / 4;
+        hard = Milliseconds(std::min(3 * share, left / 2));
+        soft = std::min(Milliseconds(share), hard / 2);
+    } else if (limits.depth < Minimax::MAX_PLY - 1) {
+        hard = soft = Milliseconds::max();
+    } else {
+        hard = Milliseconds(Minimax::DEFAULT_MOVETIME);
+        soft = hard / 2;
+    }
+}
+
+}  // namespace
+
+TranspositionTable Minimax::table;
+unsigned long long Minimax::nodes = 0;
+Move Minimax::killers[Minimax::MAX_PLY][2];
+Nnue::Accumulator Minimax::accumulators[Minimax::MAX_PLY + 1];
+Move Minimax::pv[Minimax::MAX_PLY + 1][Minimax::MAX_PLY + 1];
+int Minimax::pvLength[Minimax::MAX_PLY + 1];
+Move Minimax::previousPv[Minimax::MAX_PLY + 1];
+int Minimax::previousPvLength = 0;
+bool Minimax::followingPv = false;
+Clock::time_point Minimax::deadline = Clock::time_point::max();
+bool Minimax::stopped = false;
+
+Move Minimax::findBestMove(const Position& board,
                            Color color,
                            int depth,
-                           bool useAlphaBeta) {
+                           bool useAlphaBeta,
+                           bool verbose) {
+    return color == WHITE
+               ? findBestMove<WHITE>(board, depth, useAlphaBeta, verbose)
+               : findBestMove<BLACK>(board, depth, useAlphaBeta, verbose);
+}
+
+template <Color Us>
+Move Minimax::findBestMove(const Position& board,
+                           int depth,
+                           bool useAlphaBeta,
+                           bool verbose) {
+    constexpr Color Them = Us == WHITE ? BLACK : WHITE;
     int bestValue = std::numeric_limits<int>::min();
-    Move bestMove = Move(-1, -1, -1, -1, nullptr);
+    Move bestMove;
+    assert(depth < MAX_PLY);
+    nodes = 1;
+    deadline = Clock::time_point::max();
+    stopped = false;
+    followingPv = false;
+    Evaluation::pawnTable().stats = PawnHashTable::Stats();
+    if (useAlphaBeta) {
+        table.newSearch();
+        std::fill(&killers[0][0], &killers[0][0] + MAX_PLY * 2, Move());
+    }
+
+    // One slot per ply, reused by every node at that ply
+    Position positions[MAX_PLY + 1];
+    positions[0] = board;
+    if (Nnue::loaded()) {
+        Nnue::refresh(positions[0], accumulators[0]);
+    }
 
-    auto moves = board.generateAllMoves(color, (depth <= 1));
+    MoveList moves;
+    board.generateAllMoves<Us>((depth <= 1), moves);
     for (const auto& move : moves) {
-        board.makeMove(move);
+        playMove<Us>(positions, 0, move);
         int moveValue = useAlphaBeta
-                            ? minimaxAlphaBeta(board, depth - 1,
-                                               std::numeric_limits<int>::min(),
-                                               std::numeric_limits<int>::max(),
-                                               false, color)
-                            : minimax(board, depth - 1, false, color);
+                            ? -minimaxAlphaBeta<Them>(positions, depth - 1, 1,
+                                                      -INFINITE_SCORE,
+                                                      INFINITE_SCORE)
+                            : -minimax<Them>(positions, depth - 1, 1);
         if (moveValue > bestValue) {
             bestValue = moveValue;
             bestMove = move;
         }
-        board.unmakeMove(move);
+    }
+
+    if (useAlphaBeta && verbose) {
+        printStats();
     }
     return bestMove;
 }
 
-int Minimax::minimax(Board& board,
-                     int depth,
-                     bool isMaximizingPlayer,
-                     Color color) {
-    if (depth == 0) {
-        return evaluateBoard(board, color);
+Move Minimax::iterativeDeepening(const Position& board,
+                                 Color color,
+                                 const SearchLimits& limits,
+                                 bool verbose) {
+    return color == WHITE ? iterativeDeepening<WHITE>(board, limits, verbose)
+                          : iterativeDeepening<BLACK>(board, limits, verbose);
+}
+
+template <Color Us>
+Move Minimax::iterativeDeepening(const Position& board,
+                                 const SearchLimits& limits,
+                                 bool verbose) {
+    constexpr Color Them = Us == WHITE ? BLACK : WHITE;
+    const Clock::time_point start = Clock::now();
+    Milliseconds soft;
+    Milliseconds hard;
+    allocateTime(limits, Us, soft, hard);
+    deadline = hard == Milliseconds::max() ? Clock::time_point::max()
+                                           : start + hard;
+    stopped = false;
+    nodes = 1;
+    table.newSearch();
+    std::fill(&killers[0][0], &killers[0][0] + MAX_PLY * 2, Move());
+    Evaluation::pawnTable().stats = PawnHashTable::Stats();
+
+    Position positions[MAX_PLY + 1];
+    positions[0] = board;
+    if (Nnue::loaded()) {
+        Nnue::refresh(positions[0], accumulators[0]);
     }
 
-    auto moves = board.generateAllMoves(
-        isMaximizingPlayer ? color : (color == WHITE ? BLACK : WHITE),
-        (depth <= 1));
+    // Only legal moves at the root, so whatever is returned can be played
+    MoveList moves;
+    board.generateAllMoves<Us>(true, moves);
     if (moves.empty()) {
-        return evaluateBoard(board, color);
+        return Move();
     }
+    Move bestMove = moves[0];
+    previousPvLength = 0;
+
+    const int maxDepth = std::min(limits.depth, MAX_PLY - 1);
+    for (int depth = 1; depth <= maxDepth; ++depth) {
+        // The previous best move is searched first, the rest keep their
+        // order
+        Move* previousBest = std::find(moves.begin(), moves.end(), bestMove);
+        std::rotate(moves.begin(), previousBest, previousBest + 1);
+        followingPv = previousPvLength > 0;
 
-    if (isMaximizingPlayer) {
-        int bestValue = std::numeric_limits<int>::min();
+        int alpha = -INFINITE_SCORE;
+        Move iterationBest;
+        pvLength[0] = 0;
         for (const auto& move : moves) {
-            board.makeMove(move);
-            int moveValue = minimax(board, depth - 1, false, color);
-            bestValue = std::max(bestValue, moveValue);
-            board.unmakeMove(move);
+            playMove<Us>(positions, 0, move);
+            const int moveValue = -minimaxAlphaBeta<Them>(
+                positions, depth - 1, 1, -INFINITE_SCORE, -alpha);
+            followingPv = false;
+            if (stopped) {
+                break;
+            }
+            if (moveValue > alpha) {
+                alpha = moveValue;
+                iterationBest = move;
+                pv[0][0] = move;
+                std::copy(&pv[1][1], &pv[1][pvLength[1]], &pv[0][1]);
+                pvLength[0] = pvLength[1];
+            }
         }
-        return bestValue;
-    } else {
-        int bestValue = std::numeric_limits<int>::max();
-        for (const auto& move : moves) {
-            board.makeMove(move);
-            int moveValue = minimax(board, depth - 1, true, color);
-            bestValue = std::min(bestValue, moveValue);
-            board.unmakeMove(move);
+        if (stopped) {
+            break;
+        }
+
+        bestMove = iterationBest;
+        previousPvLength = pvLength[0];
+        std::copy(&pv[0][0], &pv[0][pvLength[0]], previousPv);
+        const auto elapsed =
+            std::chrono::duration_cast<Milliseconds>(Clock::now() - start);
+        if (verbose) {
+            std::cout << "info depth " << depth << " score cp " << alpha
+                      << " nodes " << nodes << " time " << elapsed.count()
+                      << " pv";
+            for (int i = 0; i < previousPvLength; ++i) {
+                std::cout << " " << previousPv[i].toUCI();
+            }
+            std::cout << std::endl;
         }
-        return bestValue;
+        if (elapsed >= soft) {
+            break;
+        }
+    }
+    if (verbose) {
+        printStats();
     }
+    return bestMove;
+}
+
+void Minimax::printStats() {
+    const TranspositionTable::Stats& stats = table.stats;
+    std::cout << "tt probes " << stats.probes << " hits " << stats.hits
+              << " ("
+              << (stats.probes ? 100 * stats.hits / stats.probes : 0)
+              << "%) cutoffs " << stats.cutoffs << " stores " << stats.stores
+              << " full " << table.hashfull() / 10 << "%" << std::endl;
+    const PawnHashTable::Stats& pawnStats = Evaluation::pawnTable().stats;
+    std::cout << "pawn probes " << pawnStats.probes << " hits "
+              << pawnStats.hits << " ("
+              << (pawnStats.probes ? 100 * pawnStats.hits / pawnStats.probes
+                                   : 0)
+              << "%)" << std::endl;
 }
 
-int Minimax::minimaxAlphaBeta(Board& board,
+template <Color Us>
+int Minimax::minimax(Position* positions, int depth, int ply) {
+    constexpr Color Them = Us == WHITE ? BLACK : WHITE;
+    const Position& board = positions[ply];
+    ++nodes;
+    if (depth == 0) {
+        return evaluateNode<Us>(positions, ply);
+    }
+
+    MoveList moves;
+    board.generateAllMoves<Us>((depth <= 1), moves);
+    if (moves.empty()) {
+        return evaluateNode<Us>(positions, ply);
+    }
+
+    int bestValue = -INFINITE_SCORE;
+    for (const auto& move : moves) {
+        playMove<Us>(positions, ply, move);
+        bestValue =
+            std::max(bestValue, -minimax<Them>(positions, depth - 1, ply + 1));
+    }
+    return bestValue;
+}
+
+template <Color Us>
+int Minimax::minimaxAlphaBeta(Position* positions,
                               int depth,
+                              int ply,
                               int alpha,
-                              int beta,
-                              bool isMaximizingPlayer,
-                              Color color) {
+                              int beta) {
+    constexpr Color Them = Us == WHITE ? BLACK : WHITE;
+    const Position& board = positions[ply];
+    ++nodes;
+    pvLength[ply] = ply;
+    if (nodes % TIME_CHECK_INTERVAL == 0 && Clock::now() >= deadline) {
+        stopped = true;
+    }
+    if (stopped) {
+        return 0;
+    }
     if (depth == 0) {
-        return evaluateBoard(board, color);
+        return evaluateNode<Us>(positions, ply);
     }
 
-    auto moves = board.generateAllMoves(
-        isMaximizingPlayer ? color : (color == WHITE ? BLACK : WHITE),
-        (depth <= 1));
-    if (moves.empty()) {
-        return evaluateBoard(board, color);
+    // A stored result at least this deep can settle the node outright;
+    // otherwise its move is still the best guess to search first
+    const int originalAlpha = alpha;
+    Move hashMove;
+    TranspositionTable::Entry entry;
+    if (table.probe(board.key, entry)) {
+        hashMove = entry.move;
+        if (entry.depth >= depth &&
+            (entry.bound == TranspositionTable::EXACT ||
+             (entry.bound == TranspositionTable::LOWER &&
+              entry.score >= beta) ||
+             (entry.bound == TranspositionTable::UPPER &&
+              entry.score <= alpha))) {
+            ++table.stats.cutoffs;
+            return entry.score;
+        }
+    }
+    // On the previous iteration's principal variation its move goes first,
+    // whatever the table says
+    if (followingPv) {
+        if (ply < previousPvLength) {
+            hashMove = previousPv[ply];
+        } else {
+            followingPv = false;
+        }
     }
 
-    if (isMaximizingPlayer) {
-        int bestValue = std::numeric_limits<int>::min();
-        for (const auto& move : moves) {
-            board.makeMove(move);
-            int moveValue =
-                minimaxAlphaBeta(board, depth - 1, alpha, beta, false, color);
-            bestValue = std::max(bestValue, moveValue);
-            alpha = std::max(alpha, bestValue);
-            board.unmakeMove(move);
-            if (beta <= alpha) {
-                break;
-            }
+    MovePicker<Us> picker(board, depth <= 1, hashMove, killers[ply]);
+    int bestValue = -INFINITE_SCORE;
+    Move bestMove;
+    int moveCount = 0;
+    for (Move move = picker.next(); !move.isNull(); move = picker.next()) {
+        ++moveCount;
+        const bool quiet = playMove<Us>(positions, ply, move) == NO_PIECE &&
+                           move.type() != PROMOTION;
+        int moveValue = -minimaxAlphaBeta<Them>(positions, depth - 1, ply + 1,
+                                                -beta, -alpha);
+        // Only the first move played can lie on the old variation
+        followingPv = false;
+        if (stopped) {
+            return 0;
         }
-        return bestValue;
-    } else {
-        int bestValue = std::numeric_limits<int>::max();
-        for (const auto& move : moves) {
-            board.makeMove(move);
-            int moveValue =
-                minimaxAlphaBeta(board, depth - 1, alpha, beta, true, color);
-            bestValue = std::min(bestValue, moveValue);
-            beta = std::min(beta, bestValue);
-            board.unmakeMove(move);
-            if (beta <= alpha) {
-                break;
+        if (moveValue > bestValue) {
+            bestValue = moveValue;
+            bestMove = move;
+        }
+        if (moveValue > alpha) {
+            pv[ply][ply] = move;
+            std::copy(&pv[ply + 1][ply + 1], &pv[ply + 1][pvLength[ply + 1]],
+                      &pv[ply][ply + 1]);
+            pvLength[ply] = pvLength[ply + 1];
+        }
+        alpha = std::max(alpha, bestValue);
+        if (beta <= alpha) {
+            // A quiet refutation is likely to refute the sibling moves too
+            if (quiet && killers[ply][0] != move) {
+                killers[ply][1] = killers[ply][0];
+                killers[ply][0] = move;
             }
+            break;
         }
-        return bestValue;
     }
+    if (moveCount == 0) {
+        return evaluateNode<Us>(positions, ply);
+    }
+
+    TranspositionTable::Bound bound = TranspositionTable::EXACT;
+    if (bestValue <= originalAlpha) {
+        bound = TranspositionTable::UPPER;
+    } else if (bestValue >= beta) {
+        bound = TranspositionTable::LOWER;
+    }
+    table.store(board.key, depth, bestValue, bound, bestMove);
+    return bestValue;
 }
 
-int Minimax::evaluateBoard(const Board& board, Color color) {
-    // Simple evaluation function: count material
-    int score = 0;
-    for (int row = 0; row < 8; ++row) {
-        for (int col = 0; col < 8; ++col) {
-            if (board.squares[row][col]) {
-                int pieceValue = 0;
-                switch (board.squares[row][col]->getSymbol()) {
-                    case 'P':
-                        pieceValue = 1;
-                        break;
-                    case 'N':
-                    case 'B':
-                        pieceValue = 3;
-                        break;
-                    case 'R':
-                        pieceValue = 5;
-                        break;
-                    case 'Q':
-                        pieceValue = 9;
-                        break;
-                    case 'K':
-                        pieceValue = 100;
-                        break;
-                    case 'p':
-                        pieceValue = -1;
-                        break;
-                    case 'n':
-                    case 'b':
-                        pieceValue = -3;
-                        break;
-                    case 'r':
-                        pieceValue = -5;
-                        break;
-                    case 'q':
-                        pieceValue = -9;
-                        break;
-                    case 'k':
-                        pieceValue = -100;
-                        break;
-                }
-                score += pieceValue;
-            }
+template <Color Us>
+Piece Minimax::playMove(Position* positions, int ply, Move move) {
+    Position& child = positions[ply + 1];
+    child = positions[ply];
+    const Piece captured = child.applyMove<Us>(move);
+    if (Nnue::loaded()) {
+        Nnue::update(positions[ply], accumulators[ply], child,
+                     accumulators[ply + 1]);
+    }
+    return captured;
+}
+
+template <Color Us>
+int Minimax::evaluateNode(const Position* positions, int ply) {
+    constexpr Color Them = Us == WHITE ? BLACK : WHITE;
+    if (Nnue::loaded()) {
+        // Above depth 1 the moves are pseudo-legal, so a king can be
+        // taken. The piece-square king value scores that; the network
+        // sees the king as any other piece, so it is scored here.
+        const Position& position = positions[ply];
+        if (!position.pieces[makePiece(Us, KING)]) {
+            return -(KING_CAPTURED_SCORE - ply);
+        }
+        if (!position.pieces[makePiece(Them, KING)]) {
+            return KING_CAPTURED_SCORE - ply;
         }
+        return Nnue::evaluate(accumulators[ply], Us);
     }
-    return score * (color == WHITE ? 1 : -1);
-}
\ No newline at end of file
+    return evaluateBoard(positions[ply], Us);
+}
+
+template Move Minimax::findBestMove<WHITE>(const Position&,
+                                           int,
+                                           bool,
+                                           bool);
+template Move Minimax::findBestMove<BLACK>(const Position&,
+                                           int,
+                                           bool,
+                                           bool);
+template Move Minimax::iterativeDeepening<WHITE>(const Position&,
+                                                 const SearchLimits&,
+                                                 bool);
+template Move Minimax::iterativeDeepening<BLACK>(const Position&,
+                                                 const SearchLimits&,
+                                                 bool);
+
+int Minimax::evaluateBoard(const Position& board, Color color) {
+    if (Nnue::loaded()) {
+        Nnue::Accumulator accumulator;
+        Nnue::refresh(board, accumulator);
+        return Nnue::evaluate(accumulator, color);
+    }
+    const int score = Evaluation::evaluate(board);
+    return color == WHITE ? score : -score;
+}
+
+void Minimax::evaluateBatch(std::span<const Position> positions,
+                            std::span<int> scores) {
+    if (!Nnue::loaded()) {
+        Evaluation::evaluateBatch(positions, scores);
+        return;
+    }
+    for (size_t i = 0; i < positions.size(); ++i) {
+        scores[i] = evaluateBoard(positions[i], WHITE);
+    }
+}
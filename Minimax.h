@@ -1,30 +1,130 @@
 #ifndef MINIMAX_H
 #define MINIMAX_H
 
+#include <chrono>
+#include <span>
 #include <utility>
-#include "Board.h"
+#include "Nnue.h"
+#include "Position.h"
+#include "TranspositionTable.h"
 
 class Move;
 
 class Minimax {
    public:
-    static Move findBestMove(Board& board,
+    // Deeper than any search is asked for; findBestMove checks the depth
+    static const int MAX_PLY = 64;
+
+    // Search time when SearchLimits sets neither a time nor a depth
+    static const int DEFAULT_MOVETIME = 1000;
+
+    // What iterativeDeepening may spend on a move. Times are in
+    // milliseconds, and zero leaves a limit unset. With no time set the
+    // search runs until it reaches depth, however long that takes, unless
+    // depth is left at its default too: then it gets DEFAULT_MOVETIME.
+    struct SearchLimits {
+        int depth = MAX_PLY - 1;
+        // Exactly this long for the move
+        int movetime = 0;
+        // Otherwise a share of the clock, indexed by Color, is allotted:
+        // the time left over the moves to go (a guess of 30 when unset)
+        // plus most of the increment
+        int time[2] = {0, 0};
+        int increment[2] = {0, 0};
+        int movesToGo = 0;
+    };
+
+    // board itself is left alone; the search plays its moves on copies.
+    // When verbose, an alpha-beta search prints the table stats at the end.
+    static Move findBestMove(const Position& board,
                              Color color,
                              int depth,
-                             bool useAlphaBeta);
-    static int evaluateBoard(const Board& board, Color color);
+                             bool useAlphaBeta,
+                             bool verbose = false);
+    template <Color Us>
+    static Move findBestMove(const Position& board,
+                             int depth,
+                             bool useAlphaBeta,
+                             bool verbose = false);
+    // Searches depth 1, 2, 3 and so on until limits run out, each
+    // iteration trying the previous one's principal variation first. An
+    // iteration that is cut short is thrown away, so the move returned is
+    // the best of the last one that finished (at worst any legal move).
+    // Returns the null move when color has no legal move. When verbose, a
+    // UCI info line is printed for every finished iteration and the table
+    // stats at the end.
+    static Move iterativeDeepening(const Position& board,
+                                   Color color,
+                                   const SearchLimits& limits,
+                                   bool verbose = false);
+    template <Color Us>
+    static Move iterativeDeepening(const Position& board,
+                                   const SearchLimits& limits,
+                                   bool verbose = false);
+
+    // Through the network when one is loaded, the classical Evaluation
+    // otherwise.
+    static int evaluateBoard(const Position& board, Color color);
+    // scores[i] = evaluateBoard(positions[i], WHITE) for every position,
+    // batched through Evaluation::evaluateBatch when no network is loaded.
+    static void evaluateBatch(std::span<const Position> positions,
+                              std::span<int> scores);
+
+    // Shared by every alpha-beta search and kept between them. Its stats
+    // cover the most recent search.
+    static TranspositionTable table;
+    // Positions visited by the most recent findBestMove, leaves included
+    static unsigned long long nodes;
 
    private:
-    static int minimax(Board& board,
-                       int depth,
-                       bool isMaximizingPlayer,
-                       Color color);
-    static int minimaxAlphaBeta(Board& board,
+    // Both searches are written in negamax form: Us is the side to move and
+    // the score is from its point of view, so the caller negates it. The
+    // node is positions[ply]; its children are played into positions[ply + 1]
+    // one after another, each copied fresh from the node.
+    template <Color Us>
+    static int minimax(Position* positions, int depth, int ply);
+    template <Color Us>
+    static int minimaxAlphaBeta(Position* positions,
                                 int depth,
+                                int ply,
                                 int alpha,
-                                int beta,
-                                bool isMaximizingPlayer,
-                                Color color);
+                                int beta);
+
+    // Prints the hit rates of the transposition and pawn tables over the
+    // most recent search.
+    static void printStats();
+
+    // Plays move from positions[ply] into positions[ply + 1], carrying
+    // the network's accumulator along when one is loaded, and returns the
+    // piece it captured.
+    template <Color Us>
+    static Piece playMove(Position* positions, int ply, Move move);
+    // evaluateBoard for the node at ply, reusing its accumulator.
+    template <Color Us>
+    static int evaluateNode(const Position* positions, int ply);
+
+    // The network's accumulator for each of the positions, used only
+    // while a network is loaded
+    static Nnue::Accumulator accumulators[MAX_PLY + 1];
+    // Two quiet moves per ply that recently caused a beta cutoff, tried
+    // right after the captures. Cleared at the start of every search.
+    static Move killers[MAX_PLY][2];
+
+    // The principal variation of the node at each ply, in
+    // pv[ply][ply .. pvLength[ply]), built up from the children's
+    static Move pv[MAX_PLY + 1][MAX_PLY + 1];
+    static int pvLength[MAX_PLY + 1];
+    // The previous iteration's principal variation. While followingPv is
+    // set the search is still on its path, and plays its move first.
+    static Move previousPv[MAX_PLY + 1];
+    static int previousPvLength;
+    static bool followingPv;
+
+    // When the running search has to stop, checked every few thousand
+    // nodes. Once stopped is set every node returns at once and the
+    // unfinished iteration is discarded.
+    static std::chrono::steady_clock::time_point deadline;
+    static bool stopped;
 };
 
 #endif  // MINIMAX_H
\ No newline at end of file
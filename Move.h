@@ -1,40 +1,42 @@
 #ifndef MOVE_H
 #define MOVE_H
 
-#include <memory>
+#include <cstdint>
 #include <string>
+#include "Piece.h"
 
 enum MoveType { NORMAL, PROMOTION, CASTLING, EN_PASSANT };
 
-class Piece;
-
+// Packed into 16 bits:
+//   bits 0-5    from square
+//   bits 6-11   to square
+//   bits 12-13  promotion piece, KNIGHT to QUEEN
+//   bits 14-15  MoveType
+// The moving and captured pieces are read from the board, and the board's
+// history keeps what unmakeMove needs. A default-constructed Move is the
+// null move a1a1.
 class Move {
    public:
-    Move(int startX,
-         int startY,
-         int endX,
-         int endY,
-         std::shared_ptr<Piece> piece,
-         MoveType type = NORMAL,
-         std::shared_ptr<Piece> capturedPiece = nullptr,
-         std::shared_ptr<Piece> promotionPiece = nullptr)
-        : startX(startX),
-          startY(startY),
-          endX(endX),
-          endY(endY),
-          piece(piece),
-          type(type),
-          capturedPiece(capturedPiece),
-          promotionPiece(promotionPiece) {}
-
-    int startX, startY, endX, endY;
-    std::shared_ptr<Piece> piece;
-    MoveType type;
-    std::shared_ptr<Piece> promotionPiece;
-    std::shared_ptr<Piece> capturedPiece;
+    Move() : data(0) {}
+    Move(int from, int to, MoveType type = NORMAL, PieceType promotion = KNIGHT)
+        : data(static_cast<uint16_t>(from | (to << 6) |
+                                     ((promotion - KNIGHT) << 12) |
+                                     (type << 14))) {}
+
+    int from() const { return data & 0x3F; }
+    int to() const { return (data >> 6) & 0x3F; }
+    MoveType type() const { return static_cast<MoveType>(data >> 14); }
+    PieceType promotionType() const {
+        return static_cast<PieceType>(((data >> 12) & 3) + KNIGHT);
+    }
+    bool isNull() const { return data == 0; }
+
+    bool operator==(const Move& other) const { return data == other.data; }
+    bool operator!=(const Move& other) const { return data != other.data; }
+
     std::string toString() const {
         std::string typeToString = "";
-        switch (type) {
+        switch (type()) {
             case NORMAL:
                 typeToString = "NORMAL";
                 break;
@@ -48,10 +50,27 @@ class Move {
                 typeToString = "EN_PASSANT";
                 break;
         }
-        return "(" + std::to_string(startX) + ", " + std::to_string(startY) +
-               ") (" + std::to_string(endX) + ", " + std::to_string(endY) +
-               ") " + " " + typeToString;
+        return "(" + std::to_string(from() & 7) + ", " +
+               std::to_string(from() >> 3) + ") (" + std::to_string(to() & 7) +
+               ", " + std::to_string(to() >> 3) + ") " + " " + typeToString;
     };
+
+    // Long algebraic notation as used by UCI, e.g. "e2e4" or "e7e8q"
+    std::string toUCI() const {
+        std::string uci = {static_cast<char>('a' + (from() & 7)),
+                           static_cast<char>('1' + (from() >> 3)),
+                           static_cast<char>('a' + (to() & 7)),
+                           static_cast<char>('1' + (to() >> 3))};
+        if (type() == PROMOTION) {
+            uci += "nbrq"[promotionType() - KNIGHT];
+        }
+        return uci;
+    }
+
+   private:
+    uint16_t data;
 };
 
-#endif  // MOVE_H
\ No newline at end of file
+static_assert(sizeof(Move) == 2, "Move must stay packed in 16 bits");
+
+#endif  // MOVE_H
@@ -0,0 +1,508 @@
+#include "MoveGen.h"
+#include "Position.h"
+
+Bitboard MoveGen::attacks(Piece piece, int square, Bitboard occupied) {
+    switch (pieceType(piece)) {
+        case PAWN:
+            return pawnAttacks(pieceColor(piece), square);
+        case KNIGHT:
+            return knightAttacks(square);
+        case BISHOP:
+            return bishopAttacks(square, occupied);
+        case ROOK:
+            return rookAttacks(square, occupied);
+        case QUEEN:
+            return queenAttacks(square, occupied);
+        case KING:
+            return kingAttacks(square);
+    }
+    return 0;
+}
+
+// Own pieces that are the only blocker between the king and an enemy
+// slider on the same line.
+template <Color Us>
+Bitboard MoveGen::pinnedPieces(const Position& board, int king) {
+    constexpr Color Them = Us == WHITE ? BLACK : WHITE;
+    const Bitboard occupied = board.allPieces();
+    const Bitboard queens = board.pieces[makePiece(Them, QUEEN)];
+    Bitboard snipers =
+        (rookAttacks(king, 0) &
+         (board.pieces[makePiece(Them, ROOK)] | queens)) |
+        (bishopAttacks(king, 0) &
+         (board.pieces[makePiece(Them, BISHOP)] | queens));
+
+    Bitboard pinned = 0;
+    while (snipers) {
+        Bitboard blockers = between(king, popLsb(snipers)) & occupied;
+        if (popCount(blockers) == 1) {
+            pinned |= blockers & board.occupancy[Us];
+        }
+    }
+    return pinned;
+}
+
+void MoveGen::generateLegalMoves(const Position& board,
+                                 Color color,
+                                 MoveList& moves) {
+    if (color == WHITE) {
+        generateLegalMoves<WHITE>(board, moves);
+    } else {
+        generateLegalMoves<BLACK>(board, moves);
+    }
+}
+
+template <Color Us, GenType Type>
+void MoveGen::generateLegalMoves(const Position& board, MoveList& moves) {
+    generateMoves<Us, Type, true>(board, moves);
+}
+
+template <Color Us, GenType Type>
+void MoveGen::generatePseudoLegalMoves(const Position& board, MoveList& moves) {
+    generateMoves<Us, Type, false>(board, moves);
+}
+
+template <Color Us, GenType Type, bool Legal>
+void MoveGen::generateMoves(const Position& board, MoveList& moves) {
+    constexpr Color Them = Us == WHITE ? BLACK : WHITE;
+    const Bitboard own = board.occupancy[Us];
+    const Bitboard enemies = board.occupancy[Them];
+    const Bitboard occupied = own | enemies;
+    const Bitboard typeMask = Type == CAPTURES ? enemies
+                              : Type == QUIETS ? ~occupied
+                                               : ~own;
+    // Only the pseudo-legal generator is asked about boards without a king
+    const int king = board.kingSquare(Us);
+    const Bitboard kingBB = king == -1 ? 0 : squareBB(king);
+
+    // The king may not step onto an attacked square. It is taken off the
+    // board for the test so sliders see through its old square.
+    if (king != -1) {
+        Bitboard targets = kingAttacks(king) & typeMask;
+        while (targets) {
+            int to = popLsb(targets);
+            if (!Legal ||
+                !(board.attackersTo(to, occupied ^ kingBB) & enemies)) {
+                moves.push_back(Move(king, to));
+            }
+        }
+    }
+
+    // In double check only the king can move
+    const Bitboard checkers =
+        Legal ? board.attackersTo(king, occupied) & enemies : 0;
+    if (popCount(checkers) > 1) {
+        return;
+    }
+
+    // Other pieces must capture the checker or block its line, and pinned
+    // pieces must stay on the line through their king
+    Bitboard checkMask = ~Bitboard(0);
+    if (checkers) {
+        checkMask = between(king, lsb(checkers)) | checkers;
+    } else if (Type != CAPTURES) {
+        generateCastlingMoves<Us>(board, moves);
+    }
+    const Bitboard pinned = Legal ? pinnedPieces<Us>(board, king) : 0;
+
+    // Piece by piece, each kind from its own bitboard
+    for (int type = PAWN; type <= QUEEN; ++type) {
+        const Piece piece = makePiece(Us, PieceType(type));
+        Bitboard pieces = board.pieces[piece];
+        while (pieces) {
+            int from = popLsb(pieces);
+            Bitboard allowed = checkMask;
+            if (pinned & squareBB(from)) {
+                allowed &= line(king, from);
+            }
+
+            if (type == PAWN) {
+                generatePawnMoves<Us, Type>(board, from, allowed, moves);
+                continue;
+            }
+            Bitboard targets =
+                attacks(piece, from, occupied) & typeMask & allowed;
+            while (targets) {
+                moves.push_back(Move(from, popLsb(targets)));
+            }
+        }
+    }
+
+    if (Type == QUIETS || board.enPassantSquare == -1) {
+        return;
+    }
+    Bitboard capturers = Legal ? enPassantCapturers<Us>(board, king)
+                               : pawnAttacks(Them, board.enPassantSquare) &
+                                     board.pieces[makePiece(Us, PAWN)];
+    while (capturers) {
+        moves.push_back(
+            Move(popLsb(capturers), board.enPassantSquare, EN_PASSANT));
+    }
+}
+
+template <Color Us>
+int MoveGen::countLegalMoves(const Position& board) {
+    constexpr Color Them = Us == WHITE ? BLACK : WHITE;
+    const Bitboard own = board.occupancy[Us];
+    const Bitboard enemies = board.occupancy[Them];
+    const Bitboard occupied = own | enemies;
+    const int king = board.kingSquare(Us);
+    const Bitboard kingBB = squareBB(king);
+
+    const Bitboard checkers = board.attackersTo(king, occupied) & enemies;
+
+    int count = 0;
+    Bitboard targets = kingAttacks(king) & ~own;
+    while (targets) {
+        int to = popLsb(targets);
+        if (!(board.attackersTo(to, occupied ^ kingBB) & enemies)) {
+            ++count;
+        }
+    }
+    if (popCount(checkers) > 1) {
+        return count;
+    }
+
+    Bitboard checkMask = ~Bitboard(0);
+    if (checkers) {
+        checkMask = between(king, lsb(checkers)) | checkers;
+    } else {
+        count += popCount(castlingTargets<Us>(board));
+    }
+    const Bitboard pinned = pinnedPieces<Us>(board, king);
+
+    // Free pawns are counted all at once; a pinned one gets a mask of its own
+    const Bitboard pawns = board.pieces[makePiece(Us, PAWN)];
+    count += countPawnMoves<Us>(board, pawns & ~pinned, checkMask);
+    Bitboard pinnedPawns = pawns & pinned;
+    while (pinnedPawns) {
+        int from = popLsb(pinnedPawns);
+        count += countPawnMoves<Us>(board, squareBB(from),
+                                    checkMask & line(king, from));
+    }
+
+    for (int type = KNIGHT; type <= QUEEN; ++type) {
+        const Piece piece = makePiece(Us, PieceType(type));
+        Bitboard pieces = board.pieces[piece];
+        while (pieces) {
+            int from = popLsb(pieces);
+            Bitboard allowed = checkMask;
+            if (pinned & squareBB(from)) {
+                allowed &= line(king, from);
+            }
+            count += popCount(attacks(piece, from, occupied) & ~own & allowed);
+        }
+    }
+
+    return count + popCount(enPassantCapturers<Us>(board, king));
+}
+
+// Pushes and captures of every pawn in pawns whose target is in allowed,
+// moved as one set. A promotion counts once for each piece it can become.
+template <Color Us>
+int MoveGen::countPawnMoves(const Position& board,
+                            Bitboard pawns,
+                            Bitboard allowed) {
+    constexpr Color Them = Us == WHITE ? BLACK : WHITE;
+    constexpr Bitboard FILE_A = 0x0101010101010101ULL;
+    constexpr Bitboard FILE_H = FILE_A << 7;
+    constexpr Bitboard lastRank = Us == WHITE ? 0xFFULL << 56 : 0xFFULL;
+    constexpr Bitboard thirdRank = Us == WHITE ? 0xFFULL << 16 : 0xFFULL << 40;
+    auto up = [](Bitboard b) { return Us == WHITE ? b << 8 : b >> 8; };
+
+    const Bitboard empty = ~board.allPieces();
+    const Bitboard enemies = board.occupancy[Them];
+    const Bitboard single = up(pawns) & empty;
+    const Bitboard sets[4] = {
+        single & allowed,
+        up(single & thirdRank) & empty & allowed,
+        up(pawns & ~FILE_A) >> 1 & enemies & allowed,
+        up(pawns & ~FILE_H) << 1 & enemies & allowed,
+    };
+
+    int count = 0;
+    for (Bitboard set : sets) {
+        count += popCount(set & ~lastRank) + 4 * popCount(set & lastRank);
+    }
+    return count;
+}
+
+// En passant removes two pawns from the board at once, which can expose
+// the king along the rank even when neither pawn is pinned. Play it out
+// on the occupancy and keep the capturers that leave no attacker.
+template <Color Us>
+Bitboard MoveGen::enPassantCapturers(const Position& board, int king) {
+    constexpr Color Them = Us == WHITE ? BLACK : WHITE;
+    constexpr int Up = Us == WHITE ? 8 : -8;
+    if (board.enPassantSquare == -1) {
+        return 0;
+    }
+    const int target = board.enPassantSquare;
+    const int captured = target - Up;
+    const Bitboard occupied = board.allPieces();
+    const Bitboard enemies = board.occupancy[Them] & ~squareBB(captured);
+    Bitboard capturers =
+        pawnAttacks(Them, target) & board.pieces[makePiece(Us, PAWN)];
+    Bitboard legal = 0;
+    while (capturers) {
+        int from = popLsb(capturers);
+        Bitboard after = (occupied ^ squareBB(from) ^ squareBB(captured)) |
+                         squareBB(target);
+        if (!(board.attackersTo(king, after) & enemies)) {
+            legal |= squareBB(from);
+        }
+    }
+    return legal;
+}
+
+void MoveGen::generatePieceMoves(const Position& board,
+                                 int square,
+                                 MoveList& moves) {
+    const Piece piece = board.pieceOn(square);
+    const Color color = pieceColor(piece);
+    switch (pieceType(piece)) {
+        case PAWN:
+            if (color == WHITE) {
+                generatePawnMoves<WHITE>(board, square, ~Bitboard(0), moves);
+            } else {
+                generatePawnMoves<BLACK>(board, square, ~Bitboard(0), moves);
+            }
+            if (board.enPassantSquare != -1 &&
+                (attacks(piece, square, 0) & squareBB(board.enPassantSquare))) {
+                moves.push_back(
+                    Move(square, board.enPassantSquare, EN_PASSANT));
+            }
+            break;
+        case KING: {
+            Bitboard targets = attacks(piece, square, 0) &
+                               ~board.occupancy[color];
+            while (targets) {
+                moves.push_back(Move(square, popLsb(targets)));
+            }
+            if (color == WHITE) {
+                generateCastlingMoves<WHITE>(board, moves);
+            } else {
+                generateCastlingMoves<BLACK>(board, moves);
+            }
+            break;
+        }
+        default: {
+            Bitboard targets = attacks(piece, square, board.allPieces()) &
+                               ~board.occupancy[color];
+            while (targets) {
+                moves.push_back(Move(square, popLsb(targets)));
+            }
+            break;
+        }
+    }
+}
+
+template <Color Us>
+void MoveGen::generateCastlingMoves(const Position& board, MoveList& moves) {
+    constexpr int square = Us == WHITE ? 4 : 60;
+    const Bitboard targets = castlingTargets<Us>(board);
+    if (targets & squareBB(square + 2)) {
+        moves.push_back(Move(square, square + 2, CASTLING));
+    }
+    if (targets & squareBB(square - 2)) {
+        moves.push_back(Move(square, square - 2, CASTLING));
+    }
+}
+
+// Squares the king can castle to
+template <Color Us>
+Bitboard MoveGen::castlingTargets(const Position& board) {
+    constexpr Color Them = Us == WHITE ? BLACK : WHITE;
+    constexpr int square = Us == WHITE ? 4 : 60;
+    constexpr int kingSide = Us == WHITE ? WHITE_KINGSIDE : BLACK_KINGSIDE;
+    constexpr int queenSide = Us == WHITE ? WHITE_QUEENSIDE : BLACK_QUEENSIDE;
+    if (!(board.castlingRights & (kingSide | queenSide)) ||
+        !(board.pieces[makePiece(Us, KING)] & squareBB(square))) {
+        return 0;
+    }
+    const Bitboard occupied = board.allPieces();
+    const Bitboard rooks = board.pieces[makePiece(Us, ROOK)];
+    Bitboard targets = 0;
+
+    // King-side castling
+    if ((board.castlingRights & kingSide) &&
+        !(occupied & (squareBB(square + 1) | squareBB(square + 2))) &&
+        (rooks & squareBB(square + 3))) {
+        // Check if the king is in check or if any of the squares it
+        // passes through or lands on is attacked
+        if (!board.isSquareAttacked(square, Them) &&
+            !board.isSquareAttacked(square + 1, Them) &&
+            !board.isSquareAttacked(square + 2, Them)) {
+            targets |= squareBB(square + 2);
+        }
+    }
+    // Queen-side castling
+    if ((board.castlingRights & queenSide) &&
+        !(occupied & (squareBB(square - 1) | squareBB(square - 2) |
+                      squareBB(square - 3))) &&
+        (rooks & squareBB(square - 4))) {
+        if (!board.isSquareAttacked(square, Them) &&
+            !board.isSquareAttacked(square - 1, Them) &&
+            !board.isSquareAttacked(square - 2, Them)) {
+            targets |= squareBB(square - 2);
+        }
+    }
+    return targets;
+}
+
+// Pushes, captures and promotions whose target is in allowed. En passant is
+// left to the callers, since its legality needs a check of its own.
+template <Color Us, GenType Type>
+void MoveGen::generatePawnMoves(const Position& board,
+                                int square,
+                                Bitboard allowed,
+                                MoveList& moves) {
+    constexpr Color Them = Us == WHITE ? BLACK : WHITE;
+    constexpr int Up = Us == WHITE ? 8 : -8;
+    constexpr int startRow = Us == WHITE ? 1 : 6;
+    constexpr int promotionRow = Us == WHITE ? 7 : 0;
+
+    // A pawn on its last rank only turns up in hand-made positions
+    if (rankOf(square) == promotionRow) {
+        return;
+    }
+    const bool promotes = rankOf(square + Up) == promotionRow;
+
+    // Move forward. A push that promotes counts with the captures.
+    int to = square + Up;
+    if (!(board.allPieces() & squareBB(to))) {
+        if ((squareBB(to) & allowed) &&
+            (promotes ? Type != QUIETS : Type != CAPTURES)) {
+            if (promotes) {
+                // Promotion moves
+                moves.push_back(Move(square, to, PROMOTION, QUEEN));
+                moves.push_back(Move(square, to, PROMOTION, ROOK));
+                moves.push_back(Move(square, to, PROMOTION, BISHOP));
+                moves.push_back(Move(square, to, PROMOTION, KNIGHT));
+            } else {
+                moves.push_back(Move(square, to));
+            }
+        }
+        // Move two squares forward from starting position. The masks are
+        // checked separately since only the double push may block a check.
+        if (Type != CAPTURES && rankOf(square) == startRow) {
+            int doubleTo = to + Up;
+            if (!(board.allPieces() & squareBB(doubleTo)) &&
+                (squareBB(doubleTo) & allowed)) {
+                moves.push_back(Move(square, doubleTo));
+            }
+        }
+    }
+    if (Type == QUIETS) {
+        return;
+    }
+
+    // Capture diagonally
+    Bitboard captures =
+        pawnAttacks(Us, square) & board.occupancy[Them] & allowed;
+    while (captures) {
+        to = popLsb(captures);
+        if (promotes) {
+            // Promotion capture moves
+            moves.push_back(Move(square, to, PROMOTION, QUEEN));
+            moves.push_back(Move(square, to, PROMOTION, ROOK));
+            moves.push_back(Move(square, to, PROMOTION, BISHOP));
+            moves.push_back(Move(square, to, PROMOTION, KNIGHT));
+        } else {
+            moves.push_back(Move(square, to));
+        }
+    }
+}
+
+template <Color Us>
+bool MoveGen::isPseudoLegal(const Position& board, Move move) {
+    constexpr Color Them = Us == WHITE ? BLACK : WHITE;
+    constexpr int Up = Us == WHITE ? 8 : -8;
+    constexpr int startRow = Us == WHITE ? 1 : 6;
+    constexpr int promotionRow = Us == WHITE ? 7 : 0;
+    const int from = move.from();
+    const int to = move.to();
+    const Piece piece = board.pieceOn(from);
+    if (piece == NO_PIECE || pieceColor(piece) != Us ||
+        (board.occupancy[Us] & squareBB(to))) {
+        return false;
+    }
+
+    if (move.type() == CASTLING) {
+        return pieceType(piece) == KING &&
+               (castlingTargets<Us>(board) & squareBB(to));
+    }
+    if (pieceType(piece) != PAWN) {
+        return move.type() == NORMAL &&
+               (attacks(piece, from, board.allPieces()) & squareBB(to));
+    }
+
+    if (move.type() == EN_PASSANT) {
+        return to == board.enPassantSquare &&
+               (pawnAttacks(Us, from) & squareBB(to));
+    }
+    // Promoting is compulsory on the last rank and impossible elsewhere
+    if ((move.type() == PROMOTION) != (rankOf(to) == promotionRow) ||
+        rankOf(from) == promotionRow) {
+        return false;
+    }
+    if (board.occupancy[Them] & squareBB(to)) {
+        return pawnAttacks(Us, from) & squareBB(to);
+    }
+    const Bitboard occupied = board.allPieces();
+    return !(occupied & squareBB(to)) &&
+           (to == from + Up || (to == from + 2 * Up &&
+                                rankOf(from) == startRow &&
+                                !(occupied & squareBB(from + Up))));
+}
+
+template <Color Us>
+bool MoveGen::isLegal(const Position& board, Move move) {
+    constexpr Color Them = Us == WHITE ? BLACK : WHITE;
+    const int king = board.kingSquare(Us);
+    const int from = move.from();
+    const int to = move.to();
+    const Bitboard occupied = board.allPieces();
+    const Bitboard enemies = board.occupancy[Them];
+
+    // Castling tested its squares when it was generated
+    if (move.type() == CASTLING) {
+        return true;
+    }
+    if (move.type() == EN_PASSANT) {
+        return enPassantCapturers<Us>(board, king) & squareBB(from);
+    }
+    if (from == king) {
+        return !(board.attackersTo(to, occupied ^ squareBB(king)) & enemies);
+    }
+    // Play the move out on the occupancy; a captured piece stops attacking
+    const Bitboard after = (occupied ^ squareBB(from)) | squareBB(to);
+    return !(board.attackersTo(king, after) & enemies & ~squareBB(to));
+}
+
+template void MoveGen::generateLegalMoves<WHITE, ALL>(const Position&,
+                                                      MoveList&);
+template void MoveGen::generateLegalMoves<BLACK, ALL>(const Position&,
+                                                      MoveList&);
+template void MoveGen::generateLegalMoves<WHITE, CAPTURES>(const Position&,
+                                                           MoveList&);
+template void MoveGen::generateLegalMoves<BLACK, CAPTURES>(const Position&,
+                                                           MoveList&);
+template void MoveGen::generateLegalMoves<WHITE, QUIETS>(const Position&,
+                                                         MoveList&);
+template void MoveGen::generateLegalMoves<BLACK, QUIETS>(const Position&,
+                                                         MoveList&);
+template void MoveGen::generatePseudoLegalMoves<WHITE, CAPTURES>(
+    const Position&, MoveList&);
+template void MoveGen::generatePseudoLegalMoves<BLACK, CAPTURES>(
+    const Position&, MoveList&);
+template void MoveGen::generatePseudoLegalMoves<WHITE, QUIETS>(const Position&,
+                                                               MoveList&);
+template void MoveGen::generatePseudoLegalMoves<BLACK, QUIETS>(const Position&,
+                                                               MoveList&);
+template bool MoveGen::isPseudoLegal<WHITE>(const Position&, Move);
+template bool MoveGen::isPseudoLegal<BLACK>(const Position&, Move);
+template bool MoveGen::isLegal<WHITE>(const Position&, Move);
+template bool MoveGen::isLegal<BLACK>(const Position&, Move);
+template int MoveGen::countLegalMoves<WHITE>(const Position&);
+template int MoveGen::countLegalMoves<BLACK>(const Position&);
@@ -0,0 +1,74 @@
+#ifndef MOVEGEN_H
+#define MOVEGEN_H
+
+#include "Bitboard.h"
+#include "Move.h"
+#include "MoveList.h"
+#include "Piece.h"
+
+class Position;
+
+// Which moves a generator appends. CAPTURES also covers en passant and
+// every promotion; QUIETS is everything else, castling included.
+enum GenType { CAPTURES, QUIETS, ALL };
+
+class MoveGen {
+   public:
+    // Appends every legal move for color. Checkers and pinned pieces are
+    // found once per position, and each piece's targets are masked by them,
+    // so no move has to be made to be tested.
+    static void generateLegalMoves(const Position& board,
+                                   Color color,
+                                   MoveList& moves);
+    // The same with the side to move fixed at compile time, limited to the
+    // moves of Type. The runtime overload dispatches here.
+    template <Color Us, GenType Type = ALL>
+    static void generateLegalMoves(const Position& board, MoveList& moves);
+    // The moves of Type without the king safety tests, so some may leave
+    // the own king attacked. Works without an own king on the board.
+    template <Color Us, GenType Type>
+    static void generatePseudoLegalMoves(const Position& board,
+                                         MoveList& moves);
+    // Number of moves generateLegalMoves would append, found with popcounts
+    // on the target sets instead of building each move.
+    template <Color Us>
+    static int countLegalMoves(const Position& board);
+    // Appends the pseudo-legal moves of the piece on square to moves.
+    static void generatePieceMoves(const Position& board,
+                                   int square,
+                                   MoveList& moves);
+
+    // Whether move, which may come from another position (a hash table or
+    // killer slot), is one the pseudo-legal generator would produce here.
+    template <Color Us>
+    static bool isPseudoLegal(const Position& board, Move move);
+    // Whether a pseudo-legal move keeps the own king safe.
+    template <Color Us>
+    static bool isLegal(const Position& board, Move move);
+
+    // Squares attacked by piece when it stands on square.
+    static Bitboard attacks(Piece piece, int square, Bitboard occupied);
+
+   private:
+    template <Color Us, GenType Type, bool Legal>
+    static void generateMoves(const Position& board, MoveList& moves);
+    template <Color Us>
+    static Bitboard pinnedPieces(const Position& board, int king);
+    template <Color Us>
+    static int countPawnMoves(const Position& board,
+                              Bitboard pawns,
+                              Bitboard allowed);
+    template <Color Us>
+    static Bitboard enPassantCapturers(const Position& board, int king);
+    template <Color Us>
+    static Bitboard castlingTargets(const Position& board);
+    template <Color Us, GenType Type = ALL>
+    static void generatePawnMoves(const Position& board,
+                                  int square,
+                                  Bitboard allowed,
+                                  MoveList& moves);
+    template <Color Us>
+    static void generateCastlingMoves(const Position& board, MoveList& moves);
+};
+
+#endif  // MOVEGEN_H
@@ -0,0 +1,40 @@
+#ifndef MOVELIST_H
+#define MOVELIST_H
+
+#include <algorithm>
+#include <cassert>
+#include "Move.h"
+
+// Fixed-capacity move buffer that lives on the stack. No position has more
+// than 218 legal moves, so 256 also covers pseudo-legal generation.
+class MoveList {
+   public:
+    static const int CAPACITY = 256;
+
+    MoveList() : count(0) {}
+
+    void push_back(const Move& move) {
+        assert(count < CAPACITY);
+        moves[count++] = move;
+    }
+    void clear() { count = 0; }
+    void erase(Move* first, Move* last) {
+        count = static_cast<int>(std::copy(last, end(), first) - moves);
+    }
+
+    int size() const { return count; }
+    bool empty() const { return count == 0; }
+    Move& operator[](int index) { return moves[index]; }
+    const Move& operator[](int index) const { return moves[index]; }
+
+    Move* begin() { return moves; }
+    Move* end() { return moves + count; }
+    const Move* begin() const { return moves; }
+    const Move* end() const { return moves + count; }
+
+   private:
+    Move moves[CAPACITY];
+    int count;
+};
+
+#endif  // MOVELIST_H
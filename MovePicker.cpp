@@ -0,0 +1,225 @@
+#include "MovePicker.h"
+#include <algorithm>
+#include <utility>
+#include "MoveGen.h"
+#include "Position.h"
+
+namespace {
+
+// In pawns; only how the pieces compare matters here
+const int SEE_VALUES[6] = {1, 3, 3, 5, 9, 100};
+
+bool isCapture(const Position& board, Move move) {
+    return (board.allPieces() & squareBB(move.to())) ||
+           move.type() == EN_PASSANT;
+}
+
+}  // namespace
+
+template <Color Us>
+MovePicker<Us>::MovePicker(const Position& board,
+                           bool legal,
+                           Move hashMove,
+                           const Move killers[2])
+    : board(board),
+      legal(legal && board.kingSquare(Us) != -1),
+      capturesOnly(false),
+      stage(HASH_MOVE),
+      hashMove(hashMove),
+      killers{killers[0], killers[1]},
+      index(0) {}
+
+template <Color Us>
+MovePicker<Us>::MovePicker(const Position& board, bool legal)
+    : board(board),
+      legal(legal && board.kingSquare(Us) != -1),
+      capturesOnly(true),
+      stage(GENERATE_CAPTURES),
+      index(0) {}
+
+template <Color Us>
+Move MovePicker<Us>::next() {
+    while (true) {
+        switch (stage) {
+            case HASH_MOVE:
+                stage = GENERATE_CAPTURES;
+                if (!hashMove.isNull() && isValid(hashMove)) {
+                    return hashMove;
+                }
+                hashMove = Move();
+                break;
+
+            case GENERATE_CAPTURES:
+                generateCaptures();
+                stage = GOOD_CAPTURES;
+                break;
+
+            // Picked best-first one at a time, since a cutoff usually comes
+            // before the list is done. Losing ones wait until the end.
+            case GOOD_CAPTURES:
+                while (index < moves.size()) {
+                    int best = index;
+                    for (int i = index + 1; i < moves.size(); ++i) {
+                        if (scores[i] > scores[best]) {
+                            best = i;
+                        }
+                    }
+                    std::swap(moves[index], moves[best]);
+                    std::swap(scores[index], scores[best]);
+                    Move move = moves[index++];
+                    if (see(board, move) < 0) {
+                        badCaptures.push_back(move);
+                        continue;
+                    }
+                    return move;
+                }
+                index = 0;
+                stage = PROMOTIONS;
+                break;
+
+            case PROMOTIONS:
+                if (index < promotions.size()) {
+                    return promotions[index++];
+                }
+                index = 0;
+                stage = capturesOnly ? BAD_CAPTURES : KILLERS;
+                break;
+
+            // A killer that captures here was already handed out above
+            case KILLERS:
+                while (index < 2) {
+                    Move killer = killers[index++];
+                    if (!killer.isNull() && killer != hashMove &&
+                        killer.type() != PROMOTION &&
+                        !isCapture(board, killer) && isValid(killer)) {
+                        return killer;
+                    }
+                }
+                stage = GENERATE_QUIETS;
+                break;
+
+            case GENERATE_QUIETS:
+                generateQuiets();
+                index = 0;
+                stage = QUIET_MOVES;
+                break;
+
+            case QUIET_MOVES:
+                while (index < moves.size()) {
+                    Move move = moves[index++];
+                    if (move != hashMove && move != killers[0] &&
+                        move != killers[1]) {
+                        return move;
+                    }
+                }
+                index = 0;
+                stage = BAD_CAPTURES;
+                break;
+
+            case BAD_CAPTURES:
+                if (index < badCaptures.size()) {
+                    return badCaptures[index++];
+                }
+                stage = DONE;
+                break;
+
+            case DONE:
+                return Move();
+        }
+    }
+}
+
+template <Color Us>
+bool MovePicker<Us>::isValid(Move move) const {
+    return MoveGen::isPseudoLegal<Us>(board, move) &&
+           (!legal || MoveGen::isLegal<Us>(board, move));
+}
+
+// Splits the generated moves into scored captures, kept in moves, and
+// promotions that capture nothing
+template <Color Us>
+void MovePicker<Us>::generateCaptures() {
+    if (legal) {
+        MoveGen::generateLegalMoves<Us, CAPTURES>(board, moves);
+    } else {
+        MoveGen::generatePseudoLegalMoves<Us, CAPTURES>(board, moves);
+    }
+
+    int count = 0;
+    for (const auto& move : moves) {
+        if (move == hashMove) {
+            continue;
+        }
+        if (!isCapture(board, move)) {
+            promotions.push_back(move);
+            continue;
+        }
+        const Piece victim = board.pieceOn(move.to());
+        const int victimType = victim == NO_PIECE ? PAWN : pieceType(victim);
+        scores[count] = 8 * victimType - pieceType(board.pieceOn(move.from()));
+        moves[count++] = move;
+    }
+    moves.erase(moves.begin() + count, moves.end());
+    index = 0;
+}
+
+template <Color Us>
+void MovePicker<Us>::generateQuiets() {
+    moves.clear();
+    if (legal) {
+        MoveGen::generateLegalMoves<Us, QUIETS>(board, moves);
+    } else {
+        MoveGen::generatePseudoLegalMoves<Us, QUIETS>(board, moves);
+    }
+}
+
+// Swap-list evaluation: gain[d] is what the side making the d-th capture
+// has won if the sequence stops after it. Walking back from the end, each
+// side keeps the better of capturing and standing pat. En passant counts as
+// an even trade.
+template <Color Us>
+int MovePicker<Us>::see(const Position& board, Move move) {
+    if (move.type() == EN_PASSANT) {
+        return 0;
+    }
+    const int to = move.to();
+    int gain[32];
+    int depth = 0;
+    gain[0] = SEE_VALUES[pieceType(board.pieceOn(to))];
+
+    PieceType attacker = pieceType(board.pieceOn(move.from()));
+    Bitboard fromSet = squareBB(move.from());
+    Bitboard occupied = board.allPieces();
+    Color side = Us;
+    do {
+        ++depth;
+        gain[depth] = SEE_VALUES[attacker] - gain[depth - 1];
+        // Neither side can do better than what it already has
+        if (std::max(-gain[depth - 1], gain[depth]) < 0) {
+            break;
+        }
+        // Taking the capturer off the board uncovers any slider behind it
+        occupied ^= fromSet;
+        side = side == WHITE ? BLACK : WHITE;
+        const Bitboard attackers = board.attackersTo(to, occupied) &
+                                   occupied & board.occupancy[side];
+        fromSet = 0;
+        for (int type = PAWN; type <= KING; ++type) {
+            Bitboard candidates =
+                attackers & board.pieces[makePiece(side, PieceType(type))];
+            if (candidates) {
+                fromSet = squareBB(lsb(candidates));
+                attacker = PieceType(type);
+                break;
+            }
+        }
+    } while (fromSet);
+
+    while (--depth) {
+        gain[depth - 1] = -std::max(-gain[depth - 1], gain[depth]);
+    }
+    return gain[0];
+}
+
+template class MovePicker<WHITE>;
+template class MovePicker<BLACK>;
@@ -0,0 +1,68 @@
+#ifndef MOVEPICKER_H
+#define MOVEPICKER_H
+
+#include "Move.h"
+#include "MoveList.h"
+#include "Piece.h"
+
+class Position;
+
+// Hands the search one move at a time, generating each group of moves only
+// when the one before it is used up, so a node that cuts off early never
+// pays for the rest. The order is the hash move, captures that do not lose
+// material (most valuable victim first, then least valuable attacker),
+// promotions, the killer moves, the other quiet moves in generation order,
+// and last the captures that lose material.
+template <Color Us>
+class MovePicker {
+   public:
+    // Every move. hashMove and killers may come from other positions and
+    // are checked before they are handed out; either can be null.
+    MovePicker(const Position& board,
+               bool legal,
+               Move hashMove,
+               const Move killers[2]);
+    // Captures and promotions only, losing captures last, for a
+    // quiescence search.
+    MovePicker(const Position& board, bool legal);
+
+    // The next move to search, or the null move once there are none left.
+    Move next();
+
+    // Static exchange evaluation: the material the side to move wins, in
+    // pawns, if both sides keep capturing on the target of move with their
+    // least valuable piece for as long as it pays.
+    static int see(const Position& board, Move move);
+
+   private:
+    enum Stage {
+        HASH_MOVE,
+        GENERATE_CAPTURES,
+        GOOD_CAPTURES,
+        PROMOTIONS,
+        KILLERS,
+        GENERATE_QUIETS,
+        QUIET_MOVES,
+        BAD_CAPTURES,
+        DONE
+    };
+
+    bool isValid(Move move) const;
+    void generateCaptures();
+    void generateQuiets();
+
+    const Position& board;
+    const bool legal;
+    const bool capturesOnly;
+    Stage stage;
+    Move hashMove;
+    Move killers[2];
+    int index;  // next move of the current stage's list
+
+    MoveList moves;  // captures, then the quiet moves
+    int scores[MoveList::CAPACITY];
+    MoveList promotions;
+    MoveList badCaptures;
+};
+
+#endif  // MOVEPICKER_H
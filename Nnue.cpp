@@ -0,0 +1,403 @@
+#include "Nnue.h"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <new>
+#include "Position.h"
+
+#if defined(_WIN32)
+#define NNUE_READ_FILE
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define NNUE_X86
+#include <immintrin.h>
+#endif
+
+namespace {
+
+const char MAGIC[8] = {'C', 'H', 'E', 'S', 'S', 'N', 'N', '1'};
+const size_t HEADER_BYTES = 64;
+const size_t FEATURE_WEIGHT_BYTES =
+    size_t(Nnue::INPUTS) * Nnue::HIDDEN * sizeof(int16_t);
+const size_t FEATURE_BIAS_BYTES = Nnue::HIDDEN * sizeof(int16_t);
+const size_t OUTPUT_WEIGHT_BYTES = 2 * Nnue::HIDDEN * sizeof(int16_t);
+const size_t OUTPUT_BIAS_BYTES = 64;
+const size_t FILE_BYTES = HEADER_BYTES + FEATURE_WEIGHT_BYTES +
+                          FEATURE_BIAS_BYTES + OUTPUT_WEIGHT_BYTES +
+                          OUTPUT_BIAS_BYTES;
+
+// Input of piece on square as seen by perspective
+int featureIndex(Color perspective, Piece piece, int square) {
+    if (perspective == BLACK) {
+        square ^= 56;
+    }
+    const int theirs = pieceColor(piece) == perspective ? 0 : 1;
+    return (theirs * 6 + pieceType(piece)) * 64 + square;
+}
+
+// Whether the output sum stays within 32 bits for any clipped hidden values,
+// in whatever order the kernels add it up. Otherwise it could overflow,
+// which the vector kernels would wrap and the scalar one must not do.
+bool outputFits(const int16_t* outputWeights) {
+    int64_t largest = 0;
+    for (int i = 0; i < 2 * Nnue::HIDDEN; ++i) {
+        largest += int64_t(std::abs(outputWeights[i])) * Nnue::QA;
+    }
+    return largest <= std::numeric_limits<int32_t>::max();
+}
+
+void addScalar(int16_t* values, const int16_t* column) {
+    for (int i = 0; i < Nnue::HIDDEN; ++i) {
+        values[i] += column[i];
+    }
+}
+
+void subtractScalar(int16_t* values, const int16_t* column) {
+    for (int i = 0; i < Nnue::HIDDEN; ++i) {
+        values[i] -= column[i];
+    }
+}
+
+int32_t outputScalar(const int16_t* us,
+                     const int16_t* them,
+                     const int16_t* weights) {
+    int32_t sum = 0;
+    for (int i = 0; i < Nnue::HIDDEN; ++i) {
+        sum += std::clamp<int>(us[i], 0, Nnue::QA) * weights[i];
+        sum += std::clamp<int>(them[i], 0, Nnue::QA) *
+               weights[Nnue::HIDDEN + i];
+    }
+    return sum;
+}
+
+#if defined(NNUE_X86)
+// Sixteen hidden values at a time. madd_epi16 multiplies the clipped values
+// by their weights and adds neighbouring products into 32-bit lanes, which
+// cannot overflow with the values clipped to QA and the weights load
+// accepts.
+__attribute__((target("avx2"))) void addAvx2(int16_t* values,
+                                             const int16_t* column) {
+    for (int i = 0; i < Nnue::HIDDEN; i += 16) {
+        __m256i* lane = reinterpret_cast<__m256i*>(values + i);
+        const __m256i weights = _mm256_loadu_si256(
+            reinterpret_cast<const __m256i*>(column + i));
+        _mm256_store_si256(lane,
+                           _mm256_add_epi16(_mm256_load_si256(lane), weights));
+    }
+}
+
+__attribute__((target("avx2"))) void subtractAvx2(int16_t* values,
+                                                  const int16_t* column) {
+    for (int i = 0; i < Nnue::HIDDEN; i += 16) {
+        __m256i* lane = reinterpret_cast<__m256i*>(values + i);
+        const __m256i weights = _mm256_loadu_si256(
+            reinterpret_cast<const __m256i*>(column + i));
+        _mm256_store_si256(lane,
+                           _mm256_sub_epi16(_mm256_load_si256(lane), weights));
+    }
+}
+
+__attribute__((target("avx2"))) int32_t outputAvx2(const int16_t* us,
+                                                   const int16_t* them,
+                                                   const int16_t* weights) {
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i top = _mm256_set1_epi16(Nnue::QA);
+    __m256i sum = _mm256_setzero_si256();
+    for (int half = 0; half < 2; ++half) {
+        const int16_t* values = half == 0 ? us : them;
+        const int16_t* halfWeights = weights + half * Nnue::HIDDEN;
+        for (int i = 0; i < Nnue::HIDDEN; i += 16) {
+            __m256i clipped = _mm256_load_si256(
+                reinterpret_cast<const __m256i*>(values + i));
+            clipped = _mm256_min_epi16(_mm256_max_epi16(clipped, zero), top);
+            const __m256i w = _mm256_loadu_si256(
+                reinterpret_cast<const __m256i*>(halfWeights + i));
+            sum = _mm256_add_epi32(sum, _mm256_madd_epi16(clipped, w));
+        }
+    }
+    __m128i total = _mm_add_epi32(_mm256_castsi256_si128(sum),
+                                  _mm256_extracti128_si256(sum, 1));
+    total = _mm_add_epi32(total, _mm_shuffle_epi32(total, 0x4E));
+    total = _mm_add_epi32(total, _mm_shuffle_epi32(total, 0xB1));
+    return _mm_cvtsi128_si32(total);
+}
+
+// The same eight values at a time
+__attribute__((target("sse4.1"))) void addSse41(int16_t* values,
+                                                const int16_t* column) {
+    for (int i = 0; i < Nnue::HIDDEN; i += 8) {
+        __m128i* lane = reinterpret_cast<__m128i*>(values + i);
+        const __m128i weights =
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(column + i));
+        _mm_store_si128(lane, _mm_add_epi16(_mm_load_si128(lane), weights));
+    }
+}
+
+__attribute__((target("sse4.1"))) void subtractSse41(int16_t* values,
+                                                     const int16_t* column) {
+    for (int i = 0; i < Nnue::HIDDEN; i += 8) {
+        __m128i* lane = reinterpret_cast<__m128i*>(values + i);
+        const __m128i weights =
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(column + i));
+        _mm_store_si128(lane, _mm_sub_epi16(_mm_load_si128(lane), weights));
+    }
+}
+
+__attribute__((target("sse4.1"))) int32_t outputSse41(const int16_t* us,
+                                                      const int16_t* them,
+                                                      const int16_t* weights) {
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i top = _mm_set1_epi16(Nnue::QA);
+    __m128i sum = _mm_setzero_si128();
+    for (int half = 0; half < 2; ++half) {
+        const int16_t* values = half == 0 ? us : them;
+        const int16_t* halfWeights = weights + half * Nnue::HIDDEN;
+        for (int i = 0; i < Nnue::HIDDEN; i += 8) {
+            __m128i clipped =
+                _mm_load_si128(reinterpret_cast<const __m128i*>(values + i));
+            clipped = _mm_min_epi16(_mm_max_epi16(clipped, zero), top);
+            const __m128i w = _mm_loadu_si128(
+                reinterpret_cast<const __m128i*>(halfWeights + i));
+            sum = _mm_add_epi32(sum, _mm_madd_epi16(clipped, w));
+        }
+    }
+    sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, 0x4E));
+    sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, 0xB1));
+    return _mm_cvtsi128_si32(sum);
+}
+#endif
+
+struct Kernels {
+    void (*add)(int16_t* values, const int16_t* column);
+    void (*subtract)(int16_t* values, const int16_t* column);
+    int32_t (*output)(const int16_t* us,
+                      const int16_t* them,
+                      const int16_t* weights);
+};
+
+const Kernels SCALAR_KERNELS = {addScalar, subtractScalar, outputScalar};
+#if defined(NNUE_X86)
+const Kernels SSE41_KERNELS = {addSse41, subtractSse41, outputSse41};
+const Kernels AVX2_KERNELS = {addAvx2, subtractAvx2, outputAvx2};
+#endif
+
+Nnue::Kernel activeKernel = Nnue::SCALAR;
+const Kernels* kernels = &SCALAR_KERNELS;
+
+// The file contents, mapped or (where there is no mmap) read into memory
+struct Mapping {
+    void* data = nullptr;
+    size_t size = 0;
+};
+
+Mapping mapping;
+
+bool mapFile(const std::string& path, Mapping& result) {
+#if defined(NNUE_READ_FILE)
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file.is_open()) {
+        return false;
+    }
+    result.size = static_cast<size_t>(file.tellg());
+    result.data = ::operator new(result.size, std::align_val_t(64));
+    file.seekg(0);
+    if (!file.read(static_cast<char*>(result.data), result.size)) {
+        ::operator delete(result.data, std::align_val_t(64));
+        return false;
+    }
+    return true;
+#else
+    const int fd = open(path.c_str(), O_RDONLY);
+    if (fd == -1) {
+        return false;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size == 0) {
+        close(fd);
+        return false;
+    }
+    result.size = static_cast<size_t>(info.st_size);
+    result.data = mmap(nullptr, result.size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    return result.data != MAP_FAILED;
+#endif
+}
+
+void unmapFile(Mapping& toFree) {
+    if (!toFree.data) {
+        return;
+    }
+#if defined(NNUE_READ_FILE)
+    ::operator delete(toFree.data, std::align_val_t(64));
+#else
+    munmap(toFree.data, toFree.size);
+#endif
+    toFree = Mapping();
+}
+
+}  // namespace
+
+// Views into the mapped file
+struct Nnue::Network {
+    const int16_t* featureWeights;
+    const int16_t* featureBias;
+    const int16_t* outputWeights;
+    int32_t outputBias;
+};
+
+const Nnue::Network* Nnue::network = nullptr;
+
+bool Nnue::load(const std::string& path) {
+    Mapping loading;
+    if (!mapFile(path, loading)) {
+        return false;
+    }
+    const char* bytes = static_cast<const char*>(loading.data);
+    uint32_t hidden = 0;
+    if (loading.size >= HEADER_BYTES) {
+        std::memcpy(&hidden, bytes + sizeof(MAGIC), sizeof(hidden));
+    }
+    if (loading.size != FILE_BYTES ||
+        std::memcmp(bytes, MAGIC, sizeof(MAGIC)) != 0 || hidden != HIDDEN ||
+        !outputFits(reinterpret_cast<const int16_t*>(
+            bytes + HEADER_BYTES + FEATURE_WEIGHT_BYTES +
+            FEATURE_BIAS_BYTES))) {
+        unmapFile(loading);
+        return false;
+    }
+
+    static Network loaded;
+    const char* section = bytes + HEADER_BYTES;
+    loaded.featureWeights = reinterpret_cast<const int16_t*>(section);
+    section += FEATURE_WEIGHT_BYTES;
+    loaded.featureBias = reinterpret_cast<const int16_t*>(section);
+    section += FEATURE_BIAS_BYTES;
+    loaded.outputWeights = reinterpret_cast<const int16_t*>(section);
+    section += OUTPUT_WEIGHT_BYTES;
+    std::memcpy(&loaded.outputBias, section, sizeof(loaded.outputBias));
+
+    unmapFile(mapping);
+    mapping = loading;
+    network = &loaded;
+    setKernel(supports(AVX2) ? AVX2 : supports(SSE41) ? SSE41 : SCALAR);
+    return true;
+}
+
+void Nnue::unload() {
+    network = nullptr;
+    unmapFile(mapping);
+}
+
+bool Nnue::supports(Kernel kernel) {
+    switch (kernel) {
+#if defined(NNUE_X86)
+        case AVX2:
+            return __builtin_cpu_supports("avx2");
+        case SSE41:
+            return __builtin_cpu_supports("sse4.1");
+#endif
+        case SCALAR:
+            return true;
+        default:
+            return false;
+    }
+}
+
+bool Nnue::setKernel(Kernel kernel) {
+    if (!supports(kernel)) {
+        return false;
+    }
+    activeKernel = kernel;
+    switch (kernel) {
+#if defined(NNUE_X86)
+        case AVX2:
+            kernels = &AVX2_KERNELS;
+            break;
+        case SSE41:
+            kernels = &SSE41_KERNELS;
+            break;
+#endif
+        default:
+            kernels = &SCALAR_KERNELS;
+            break;
+    }
+    return true;
+}
+
+Nnue::Kernel Nnue::kernel() {
+    return activeKernel;
+}
+
+void Nnue::refresh(const Position& position, Accumulator& accumulator) {
+    for (int side = WHITE; side <= BLACK; ++side) {
+        std::copy(network->featureBias, network->featureBias + HIDDEN,
+                  accumulator.values[side]);
+    }
+    for (int piece = 0; piece < 12; ++piece) {
+        Bitboard bits = position.pieces[piece];
+        while (bits) {
+            const int square = popLsb(bits);
+            for (int side = WHITE; side <= BLACK; ++side) {
+                const int index =
+                    featureIndex(Color(side), Piece(piece), square);
+                kernels->add(accumulator.values[side],
+                             network->featureWeights + index * HIDDEN);
+            }
+        }
+    }
+}
+
+// A move changes at most four pieces (castling moves two, a capturing
+// promotion removes two and adds one), so the diff is short whatever the
+// move was
+void Nnue::update(const Position& parent,
+                  const Accumulator& parentAccumulator,
+                  const Position& child,
+                  Accumulator& childAccumulator) {
+    childAccumulator = parentAccumulator;
+    for (int piece = 0; piece < 12; ++piece) {
+        const Bitboard before = parent.pieces[piece];
+        const Bitboard after = child.pieces[piece];
+        if (before == after) {
+            continue;
+        }
+        Bitboard removed = before & ~after;
+        while (removed) {
+            const int square = popLsb(removed);
+            for (int side = WHITE; side <= BLACK; ++side) {
+                const int index =
+                    featureIndex(Color(side), Piece(piece), square);
+                kernels->subtract(childAccumulator.values[side],
+                                  network->featureWeights + index * HIDDEN);
+            }
+        }
+        Bitboard added = after & ~before;
+        while (added) {
+            const int square = popLsb(added);
+            for (int side = WHITE; side <= BLACK; ++side) {
+                const int index =
+                    featureIndex(Color(side), Piece(piece), square);
+                kernels->add(childAccumulator.values[side],
+                             network->featureWeights + index * HIDDEN);
+            }
+        }
+    }
+}
+
+int Nnue::evaluate(const Accumulator& accumulator, Color side) {
+    const Color other = side == WHITE ? BLACK : WHITE;
+    const int64_t output =
+        int64_t(kernels->output(accumulator.values[side],
+                                accumulator.values[other],
+                                network->outputWeights)) +
+        network->outputBias;
+    return static_cast<int>(output * SCALE / (QA * QB));
+}
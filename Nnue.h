@@ -0,0 +1,84 @@
+#ifndef NNUE_H
+#define NNUE_H
+
+#include <cstdint>
+#include <string>
+#include "Piece.h"
+
+class Position;
+
+// Efficiently updatable neural network evaluation. There is one input per
+// piece type, color and square (768 in all). Each side sees them from its
+// own end of the board, with its own pieces first, and sums them into a
+// hidden layer of its own. The output neuron reads both hidden layers
+// through a clipped ReLU, the side to move's first. Since a move only
+// turns a few inputs on or off, the hidden sums (the accumulator) are
+// carried from parent to child instead of being recomputed.
+//
+// The network file is little-endian, and each section starts at a multiple
+// of 64 bytes so it can be used straight from the mapping:
+//   header          "CHESSNN1", the hidden size as uint32, zero padding
+//   feature weights int16[768][HIDDEN], one column per input
+//   feature bias    int16[HIDDEN]
+//   output weights  int16[2 * HIDDEN], the side to move's half first
+//   output bias     int32, zero padding
+// Hidden values are clipped to [0, QA] and the output is scaled by
+// SCALE / (QA * QB) into centipawns. load rejects output weights whose
+// absolute values times QA add up to more than INT32_MAX, so the output
+// sum always fits 32 bits.
+//
+// The accumulators are not kept by Board::makeMove and unmakeMove, whose
+// callers rarely evaluate; the search carries them itself, updating each
+// child's from the pieces that changed between parent and child.
+class Nnue {
+   public:
+    static const int INPUTS = 768;
+    static const int HIDDEN = 256;
+    static const int QA = 255;
+    static const int QB = 64;
+    static const int SCALE = 400;
+    // File the front ends look for in the working directory
+    static constexpr const char* DEFAULT_FILE = "nnue.bin";
+
+    // The hidden layer sums of both sides, indexed by Color
+    struct Accumulator {
+        alignas(32) int16_t values[2][HIDDEN];
+    };
+
+    // Instruction sets the inner loops are written for. All give the same
+    // results; the scalar one is the reference.
+    enum Kernel { SCALAR, SSE41, AVX2 };
+
+    // Maps the network file into memory and switches the search over to
+    // it. On failure the previous state is kept and false is returned, so
+    // without a file the classical evaluation stays in use. Scores already
+    // in Minimax::table came from the previous evaluation; clear it when
+    // switching between searches.
+    static bool load(const std::string& path);
+    static void unload();
+    static bool loaded() { return network != nullptr; }
+
+    // load picks the best kernel the CPU supports. This forces another one
+    // and fails if the CPU cannot run it.
+    static bool setKernel(Kernel kernel);
+    static Kernel kernel();
+    static bool supports(Kernel kernel);
+
+    // The accumulator of position computed from scratch.
+    static void refresh(const Position& position, Accumulator& accumulator);
+    // The accumulator of child from the one of parent, touching only the
+    // inputs of the pieces that differ between the two positions.
+    static void update(const Position& parent,
+                       const Accumulator& parentAccumulator,
+                       const Position& child,
+                       Accumulator& childAccumulator);
+    // Score in centipawns from the point of view of side, with side
+    // taken to be the one to move.
+    static int evaluate(const Accumulator& accumulator, Color side);
+
+   private:
+    struct Network;
+    static const Network* network;
+};
+
+#endif  // NNUE_H
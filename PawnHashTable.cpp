@@ -0,0 +1,33 @@
+#include "PawnHashTable.h"
+#include <algorithm>
+#include "Position.h"
+
+PawnHashTable::PawnHashTable() : entries(ENTRIES) {}
+
+void PawnHashTable::clear() {
+    // An empty entry stands for positions without pawns, whose terms are
+    // all zero, so it is a valid entry too
+    std::fill(entries.begin(), entries.end(), Entry{});
+    stats = Stats();
+}
+
+PawnHashTable::Entry& PawnHashTable::probe(const Position& position,
+                                           bool& found) {
+    const Bitboard white = position.pieces[WHITE_PAWN];
+    const Bitboard black = position.pieces[BLACK_PAWN];
+    // Pawns only stand on the middle six ranks; multiplying moves their
+    // bits into the top of the product, which picks the slot
+    const uint64_t hash = white * 0x9e3779b97f4a7c15ULL ^
+                          black * 0xc2b2ae3d27d4eb4fULL;
+    Entry& entry = entries[hash >> (64 - INDEX_BITS)];
+
+    ++stats.probes;
+    found = entry.pawns[WHITE] == white && entry.pawns[BLACK] == black;
+    if (found) {
+        ++stats.hits;
+    } else {
+        entry.pawns[WHITE] = white;
+        entry.pawns[BLACK] = black;
+    }
+    return entry;
+}
@@ -0,0 +1,50 @@
+#ifndef PAWNHASHTABLE_H
+#define PAWNHASHTABLE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "Bitboard.h"
+
+class Position;
+
+// Cache of the pawn structure terms of the evaluation. Pawns move far less
+// often than the other pieces, so most positions a search evaluates share
+// their pawns with one evaluated shortly before. The key is the pair of
+// pawn bitboards itself: it takes no room in Position, needs no updating
+// as moves are played, and never lets two pawn structures collide.
+class PawnHashTable {
+   public:
+    static const int INDEX_BITS = 14;
+    static const size_t ENTRIES = size_t(1) << INDEX_BITS;
+
+    struct Entry {
+        Bitboard pawns[2];  // indexed by Color; the key
+        Bitboard passed;    // the passed pawns of both colors
+        int16_t middlegame;
+        int16_t endgame;
+    };
+
+    struct Stats {
+        unsigned long long probes = 0;
+        unsigned long long hits = 0;
+    };
+
+    PawnHashTable();
+
+    void clear();
+    // The slot for the pawns of position. found tells whether it already
+    // holds their terms; if not it has been claimed for them and the
+    // caller fills in the rest.
+    Entry& probe(const Position& position, bool& found);
+
+    Stats stats;
+
+   private:
+    std::vector<Entry> entries;
+};
+
+static_assert(sizeof(PawnHashTable::Entry) <= 32,
+              "Two entries must fit in one cache line");
+
+#endif  // PAWNHASHTABLE_H
@@ -1,83 +1,53 @@
 #ifndef PIECE_H
 #define PIECE_H
 
-#include <memory>
-#include <vector>
-#include "Move.h"
-
-class Board;
-
-enum Color { WHITE, BLACK };
-
-class Piece {
-   public:
-    Piece(Color color) : color(color) {}
-    virtual ~Piece() {}
-    virtual char getSymbol() const = 0;
-    Color getColor() const { return color; }
-    virtual std::vector<Move> generateValidMoves(int startX,
-                                                 int startY,
-                                                 const Board* board) const = 0;
-
-   private:
-    Color color;
-};
-
-class King : public Piece {
-   public:
-    King(Color color) : Piece(color) {}
-    char getSymbol() const;
-    std::vector<Move> generateValidMoves(int startX,
-                                         int startY,
-                                         const Board* board) const override;
-
-   private:
-    bool isSquareAttacked(int x, int y, const Board* board) const;
+#include <cstdint>
+
+enum Color : uint8_t { WHITE, BLACK };
+
+enum PieceType { PAWN, KNIGHT, BISHOP, ROOK, QUEEN, KING };
+
+// A piece is one byte: color * 6 + type, or NO_PIECE for an empty square.
+// Indexes Position::pieces.
+enum Piece : uint8_t {
+    WHITE_PAWN,
+    WHITE_KNIGHT,
+    WHITE_BISHOP,
+    WHITE_ROOK,
+    WHITE_QUEEN,
+    WHITE_KING,
+    BLACK_PAWN,
+    BLACK_KNIGHT,
+    BLACK_BISHOP,
+    BLACK_ROOK,
+    BLACK_QUEEN,
+    BLACK_KING,
+    NO_PIECE
 };
 
-class Queen : public Piece {
-   public:
-    Queen(Color color) : Piece(color) {}
-    char getSymbol() const;
-    std::vector<Move> generateValidMoves(int startX,
-                                         int startY,
-                                         const Board* board) const override;
-};
+inline Piece makePiece(Color color, PieceType type) {
+    return static_cast<Piece>(color * 6 + type);
+}
 
-class Rook : public Piece {
-   public:
-    Rook(Color color) : Piece(color) {}
-    char getSymbol() const;
-    std::vector<Move> generateValidMoves(int startX,
-                                         int startY,
-                                         const Board* board) const override;
-};
+inline Color pieceColor(Piece piece) {
+    return piece < BLACK_PAWN ? WHITE : BLACK;
+}
 
-class Bishop : public Piece {
-   public:
-    Bishop(Color color) : Piece(color) {}
-    char getSymbol() const;
-    std::vector<Move> generateValidMoves(int startX,
-                                         int startY,
-                                         const Board* board) const override;
-};
+inline PieceType pieceType(Piece piece) {
+    return static_cast<PieceType>(piece % 6);
+}
 
-class Knight : public Piece {
-   public:
-    Knight(Color color) : Piece(color) {}
-    char getSymbol() const;
-    std::vector<Move> generateValidMoves(int startX,
-                                         int startY,
-                                         const Board* board) const override;
-};
+inline char pieceSymbol(Piece piece) {
+    return "PNBRQKpnbrqk."[piece];
+}
 
-class Pawn : public Piece {
-   public:
-    Pawn(Color color) : Piece(color) {}
-    char getSymbol() const;
-    std::vector<Move> generateValidMoves(int startX,
-                                         int startY,
-                                         const Board* board) const override;
-};
+inline Piece pieceFromSymbol(char symbol) {
+    for (int piece = WHITE_PAWN; piece < NO_PIECE; ++piece) {
+        if (pieceSymbol(static_cast<Piece>(piece)) == symbol) {
+            return static_cast<Piece>(piece);
+        }
+    }
+    return NO_PIECE;
+}
 
-#endif  // PIECE_H
\ No newline at end of file
+#endif  // PIECE_H
@@ -0,0 +1,142 @@
+#include "PieceSquareTables.h"
+#include "Piece.h"
+
+namespace {
+
+using Table = std::array<int16_t, 64>;
+
+constexpr int MIDDLEGAME_VALUES[6] = {100, 320, 330, 500, 900, 10000};
+constexpr int ENDGAME_VALUES[6] = {120, 300, 320, 520, 950, 10000};
+
+// Bonuses for a white piece, laid out as the board is printed: the first
+// row is rank 8 and the last is rank 1.
+constexpr Table PAWN_MIDDLEGAME = {
+    0,  0,  0,   0,   0,   0,   0,  0,   //
+    50, 50, 50,  50,  50,  50,  50, 50,  //
+    10, 10, 20,  30,  30,  20,  10, 10,  //
+    5,  5,  10,  25,  25,  10,  5,  5,   //
+    0,  0,  0,   20,  20,  0,   0,  0,   //
+    5,  -5, -10, 0,   0,   -10, -5, 5,   //
+    5,  10, 10,  -20, -20, 10,  10, 5,   //
+    0,  0,  0,   0,   0,   0,   0,  0,   //
+};
+
+// Passed or not, a pawn is worth more the closer it is to promoting
+constexpr Table PAWN_ENDGAME = {
+    0,  0,  0,  0,  0,  0,  0,  0,   //
+    80, 80, 80, 80, 80, 80, 80, 80,  //
+    50, 50, 50, 50, 50, 50, 50, 50,  //
+    30, 30, 30, 30, 30, 30, 30, 30,  //
+    15, 15, 15, 15, 15, 15, 15, 15,  //
+    5,  5,  5,  5,  5,  5,  5,  5,   //
+    0,  0,  0,  0,  0,  0,  0,  0,   //
+    0,  0,  0,  0,  0,  0,  0,  0,   //
+};
+
+constexpr Table KNIGHT = {
+    -50, -40, -30, -30, -30, -30, -40, -50,  //
+    -40, -20, 0,   0,   0,   0,   -20, -40,  //
+    -30, 0,   10,  15,  15,  10,  0,   -30,  //
+    -30, 5,   15,  20,  20,  15,  5,   -30,  //
+    -30, 0,   15,  20,  20,  15,  0,   -30,  //
+    -30, 5,   10,  15,  15,  10,  5,   -30,  //
+    -40, -20, 0,   5,   5,   0,   -20, -40,  //
+    -50, -40, -30, -30, -30, -30, -40, -50,  //
+};
+
+constexpr Table BISHOP = {
+    -20, -10, -10, -10, -10, -10, -10, -20,  //
+    -10, 0,   0,   0,   0,   0,   0,   -10,  //
+    -10, 0,   5,   10,  10,  5,   0,   -10,  //
+    -10, 5,   5,   10,  10,  5,   5,   -10,  //
+    -10, 0,   10,  10,  10,  10,  0,   -10,  //
+    -10, 10,  10,  10,  10,  10,  10,  -10,  //
+    -10, 5,   0,   0,   0,   0,   5,   -10,  //
+    -20, -10, -10, -10, -10, -10, -10, -20,  //
+};
+
+constexpr Table ROOK = {
+    0,  0,  0,  0,  0,  0,  0,  0,   //
+    5,  10, 10, 10, 10, 10, 10, 5,   //
+    -5, 0,  0,  0,  0,  0,  0,  -5,  //
+    -5, 0,  0,  0,  0,  0,  0,  -5,  //
+    -5, 0,  0,  0,  0,  0,  0,  -5,  //
+    -5, 0,  0,  0,  0,  0,  0,  -5,  //
+    -5, 0,  0,  0,  0,  0,  0,  -5,  //
+    0,  0,  0,  5,  5,  0,  0,  0,   //
+};
+
+constexpr Table QUEEN = {
+    -20, -10, -10, -5, -5, -10, -10, -20,  //
+    -10, 0,   0,   0,  0,  0,   0,   -10,  //
+    -10, 0,   5,   5,  5,  5,   0,   -10,  //
+    -5,  0,   5,   5,  5,  5,   0,   -5,   //
+    0,   0,   5,   5,  5,  5,   0,   -5,   //
+    -10, 5,   5,   5,  5,  5,   0,   -10,  //
+    -10, 0,   5,   0,  0,  0,   0,   -10,  //
+    -20, -10, -10, -5, -5, -10, -10, -20,  //
+};
+
+// Tucked away behind its pawns while there is material to attack it...
+constexpr Table KING_MIDDLEGAME = {
+    -30, -40, -40, -50, -50, -40, -40, -30,  //
+    -30, -40, -40, -50, -50, -40, -40, -30,  //
+    -30, -40, -40, -50, -50, -40, -40, -30,  //
+    -30, -40, -40, -50, -50, -40, -40, -30,  //
+    -20, -30, -30, -40, -40, -30, -30, -20,  //
+    -10, -20, -20, -20, -20, -20, -20, -10,  //
+    20,  20,  0,   0,   0,   0,   20,  20,   //
+    20,  30,  10,  0,   0,   10,  30,  20,   //
+};
+
+// ...and in the middle of the board once there is not
+constexpr Table KING_ENDGAME = {
+    -50, -40, -30, -20, -20, -30, -40, -50,  //
+    -30, -20, -10, 0,   0,   -10, -20, -30,  //
+    -30, -10, 20,  30,  30,  20,  -10, -30,  //
+    -30, -10, 30,  40,  40,  30,  -10, -30,  //
+    -30, -10, 30,  40,  40,  30,  -10, -30,  //
+    -30, -10, 20,  30,  30,  20,  -10, -30,  //
+    -30, -30, 0,   0,   0,   0,   -30, -30,  //
+    -50, -30, -30, -30, -30, -30, -30, -50,  //
+};
+
+// Only the pawns and the king change their minds about where they belong
+constexpr const Table* MIDDLEGAME_TABLES[6] = {
+    &PAWN_MIDDLEGAME, &KNIGHT, &BISHOP, &ROOK, &QUEEN, &KING_MIDDLEGAME};
+constexpr const Table* ENDGAME_TABLES[6] = {
+    &PAWN_ENDGAME, &KNIGHT, &BISHOP, &ROOK, &QUEEN, &KING_ENDGAME};
+
+// Indexes the twelve pieces by Piece and the squares a1 = 0 upwards
+constexpr std::array<Table, 12> makeTables(const Table* const bonuses[6],
+                                           const int values[6]) {
+    std::array<Table, 12> tables{};
+    for (int type = 0; type < 6; ++type) {
+        for (int square = 0; square < 64; ++square) {
+            const int rank = square / 8;
+            const int file = square % 8;
+            // Row 0 of a bonus table is rank 8 for white, rank 1 for black
+            tables[type][square] = static_cast<int16_t>(
+                values[type] + (*bonuses[type])[(7 - rank) * 8 + file]);
+            tables[6 + type][square] = static_cast<int16_t>(
+                -(values[type] + (*bonuses[type])[rank * 8 + file]));
+        }
+    }
+    return tables;
+}
+
+}  // namespace
+
+constexpr std::array<std::array<int16_t, 64>, 12> pieceSquareMiddlegame =
+    makeTables(MIDDLEGAME_TABLES, MIDDLEGAME_VALUES);
+constexpr std::array<std::array<int16_t, 64>, 12> pieceSquareEndgame =
+    makeTables(ENDGAME_TABLES, ENDGAME_VALUES);
+
+constexpr std::array<uint8_t, 12> piecePhase = {0, 1, 1, 2, 4, 0,
+                                                0, 1, 1, 2, 4, 0};
+
+// b1 for white mirrors b8 for black
+static_assert(pieceSquareMiddlegame[WHITE_KNIGHT][1] ==
+              -pieceSquareMiddlegame[BLACK_KNIGHT][57]);
+static_assert(pieceSquareEndgame[WHITE_PAWN][52] ==
+              -pieceSquareEndgame[BLACK_PAWN][12]);
@@ -0,0 +1,29 @@
+#ifndef PIECESQUARETABLES_H
+#define PIECESQUARETABLES_H
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+
+// Value of each piece on each square in centipawns, material included, one
+// table for the middlegame and one for the endgame. Black's entries are
+// white's mirrored and negated, so summing over the board gives white's
+// advantage and the start position sums to zero. The king counts as 100
+// pawns so that a search which lets it be captured sees the loss.
+extern const std::array<std::array<int16_t, 64>, 12> pieceSquareMiddlegame;
+extern const std::array<std::array<int16_t, 64>, 12> pieceSquareEndgame;
+
+// What each piece adds to the game phase, which blends the two tables:
+// MAX_PHASE with every minor and major piece still on the board, falling
+// to 0 once only kings and pawns are left.
+extern const std::array<uint8_t, 12> piecePhase;
+const int MAX_PHASE = 24;
+
+// Blends a middlegame and an endgame score by phase. Promotions can push
+// the phase past MAX_PHASE; that is still all middlegame.
+inline int taper(int middlegame, int endgame, int phase) {
+    phase = std::min(phase, MAX_PHASE);
+    return (middlegame * phase + endgame * (MAX_PHASE - phase)) / MAX_PHASE;
+}
+
+#endif  // PIECESQUARETABLES_H
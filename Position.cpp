@@ -0,0 +1,270 @@
+#include "Position.h"
+#include <cstdlib>
+#include <iostream>
+#include "MoveGen.h"
+#include "PieceSquareTables.h"
+#include "Zobrist.h"
+
+template <Color Us>
+Piece Position::applyMove(Move move) {
+    constexpr Color Them = Us == WHITE ? BLACK : WHITE;
+    constexpr int Up = Us == WHITE ? 8 : -8;
+    const int from = move.from();
+    const int to = move.to();
+    const Piece piece = pieceOn(from);
+
+    // The captured pawn sits behind the target square for en passant
+    const int captureSquare = move.type() == EN_PASSANT ? to - Up : to;
+    const Piece captured = occupancy[Them] & squareBB(captureSquare)
+                               ? pieceOn(captureSquare)
+                               : NO_PIECE;
+
+    if (enPassantSquare != -1) {
+        key ^= enPassantKey();
+    }
+    if (captured != NO_PIECE) {
+        removePiece(captured, captureSquare);
+        key ^= zobristPieceKeys[captured][captureSquare];
+    }
+
+    if (piece == makePiece(Us, PAWN) && to - from == 2 * Up) {
+        enPassantSquare = from + Up;
+    } else {
+        enPassantSquare = -1;
+    }
+
+    // Handle castling
+    if (move.type() == CASTLING) {
+        const Piece rook = makePiece(Us, ROOK);
+        const int rookFrom = to > from ? to + 1 : to - 2;
+        const int rookTo = to > from ? to - 1 : to + 1;
+        movePiece(rook, rookFrom, rookTo);
+        key ^=
+            zobristPieceKeys[rook][rookFrom] ^ zobristPieceKeys[rook][rookTo];
+    }
+    if (castlingRights) {
+        const uint8_t oldRights = castlingRights;
+        clearCastlingRights(from);
+        clearCastlingRights(to);
+        key ^= zobristCastlingKeys[oldRights] ^
+               zobristCastlingKeys[castlingRights];
+    }
+
+    // Handle promotion
+    if (move.type() == PROMOTION) {
+        const Piece promoted = makePiece(Us, move.promotionType());
+        removePiece(piece, from);
+        putPiece(promoted, to);
+        key ^= zobristPieceKeys[piece][from] ^ zobristPieceKeys[promoted][to];
+    } else {
+        movePiece(piece, from, to);
+        key ^= zobristPieceKeys[piece][from] ^ zobristPieceKeys[piece][to];
+    }
+
+    activeColor = Them;
+    key ^= zobristSideKey;
+    if (enPassantSquare != -1) {
+        key ^= enPassantKey();
+    }
+    return captured;
+}
+
+void Position::generateAllMoves(Color color,
+                                bool legal,
+                                MoveList& moves) const {
+    if (color == WHITE) {
+        generateAllMoves<WHITE>(legal, moves);
+    } else {
+        generateAllMoves<BLACK>(legal, moves);
+    }
+}
+
+template <Color Us>
+void Position::generateAllMoves(bool legal, MoveList& moves) const {
+    // A position without this king (hand-made FENs) has no legality to keep
+    if (legal && kingSquare(Us) != -1) {
+        MoveGen::generateLegalMoves<Us>(*this, moves);
+        return;
+    }
+    Bitboard own = occupancy[Us];
+    while (own) {
+        MoveGen::generatePieceMoves(*this, popLsb(own), moves);
+    }
+}
+
+int Position::countLegalMoves(Color color) const {
+    return color == WHITE ? countLegalMoves<WHITE>()
+                          : countLegalMoves<BLACK>();
+}
+
+template <Color Us>
+int Position::countLegalMoves() const {
+    if (kingSquare(Us) != -1) {
+        return MoveGen::countLegalMoves<Us>(*this);
+    }
+    int count = 0;
+    Bitboard own = occupancy[Us];
+    while (own) {
+        MoveList moves;
+        MoveGen::generatePieceMoves(*this, popLsb(own), moves);
+        count += moves.size();
+    }
+    return count;
+}
+
+template Piece Position::applyMove<WHITE>(Move);
+template Piece Position::applyMove<BLACK>(Move);
+template void Position::generateAllMoves<WHITE>(bool, MoveList&) const;
+template void Position::generateAllMoves<BLACK>(bool, MoveList&) const;
+template int Position::countLegalMoves<WHITE>() const;
+template int Position::countLegalMoves<BLACK>() const;
+
+// The color's five other bitboards are tried in turn; the king is whatever
+// is left
+Piece Position::pieceOn(int square) const {
+    const Bitboard bit = squareBB(square);
+    if (!(allPieces() & bit)) {
+        return NO_PIECE;
+    }
+    const int first = occupancy[WHITE] & bit ? WHITE_PAWN : BLACK_PAWN;
+    for (int piece = first; piece < first + KING; ++piece) {
+        if (pieces[piece] & bit) {
+            return Piece(piece);
+        }
+    }
+    return Piece(first + KING);
+}
+
+void Position::putPiece(Piece piece, int square) {
+    pieces[piece] |= squareBB(square);
+    occupancy[pieceColor(piece)] |= squareBB(square);
+    middlegameScore += pieceSquareMiddlegame[piece][square];
+    endgameScore += pieceSquareEndgame[piece][square];
+    phase += piecePhase[piece];
+}
+
+void Position::removePiece(Piece piece, int square) {
+    pieces[piece] &= ~squareBB(square);
+    occupancy[pieceColor(piece)] &= ~squareBB(square);
+    middlegameScore -= pieceSquareMiddlegame[piece][square];
+    endgameScore -= pieceSquareEndgame[piece][square];
+    phase -= piecePhase[piece];
+}
+
+void Position::movePiece(Piece piece, int from, int to) {
+    Bitboard fromTo = squareBB(from) | squareBB(to);
+    pieces[piece] ^= fromTo;
+    occupancy[pieceColor(piece)] ^= fromTo;
+    middlegameScore += pieceSquareMiddlegame[piece][to] -
+                       pieceSquareMiddlegame[piece][from];
+    endgameScore +=
+        pieceSquareEndgame[piece][to] - pieceSquareEndgame[piece][from];
+}
+
+// Any move from or to a king or rook home square loses the matching rights,
+// which also covers rooks captured before they ever moved.
+void Position::clearCastlingRights(int square) {
+    switch (square) {
+        case 4:
+            castlingRights &= ~(WHITE_KINGSIDE | WHITE_QUEENSIDE);
+            break;
+        case 60:
+            castlingRights &= ~(BLACK_KINGSIDE | BLACK_QUEENSIDE);
+            break;
+        case 0:
+            castlingRights &= ~WHITE_QUEENSIDE;
+            break;
+        case 7:
+            castlingRights &= ~WHITE_KINGSIDE;
+            break;
+        case 56:
+            castlingRights &= ~BLACK_QUEENSIDE;
+            break;
+        case 63:
+            castlingRights &= ~BLACK_KINGSIDE;
+            break;
+        default:
+            break;
+    }
+}
+
+Bitboard Position::attackersTo(int square, Bitboard occupied) const {
+    const Bitboard queens = pieces[WHITE_QUEEN] | pieces[BLACK_QUEEN];
+    return (pawnAttacks(BLACK, square) & pieces[WHITE_PAWN]) |
+           (pawnAttacks(WHITE, square) & pieces[BLACK_PAWN]) |
+           (knightAttacks(square) &
+            (pieces[WHITE_KNIGHT] | pieces[BLACK_KNIGHT])) |
+           (kingAttacks(square) & (pieces[WHITE_KING] | pieces[BLACK_KING])) |
+           (bishopAttacks(square, occupied) &
+            (pieces[WHITE_BISHOP] | pieces[BLACK_BISHOP] | queens)) |
+           (rookAttacks(square, occupied) &
+            (pieces[WHITE_ROOK] | pieces[BLACK_ROOK] | queens));
+}
+
+// The en passant file only counts while the side to move has a pawn that
+// could capture, so a double push that nothing can take does not give the
+// same position a second key.
+uint64_t Position::enPassantKey() const {
+    if (enPassantSquare == -1 ||
+        !(pawnAttacks(activeColor == WHITE ? BLACK : WHITE, enPassantSquare) &
+          pieces[makePiece(activeColor, PAWN)])) {
+        return 0;
+    }
+    return zobristEnPassantKeys[fileOf(enPassantSquare)];
+}
+
+uint64_t Position::computeKey() const {
+    uint64_t fullKey = 0;
+    for (int piece = 0; piece < 12; ++piece) {
+        Bitboard bits = pieces[piece];
+        while (bits) {
+            fullKey ^= zobristPieceKeys[piece][popLsb(bits)];
+        }
+    }
+    if (activeColor == BLACK) {
+        fullKey ^= zobristSideKey;
+    }
+    return fullKey ^ zobristCastlingKeys[castlingRights] ^ enPassantKey();
+}
+
+int Position::evaluate() const {
+    const int score = taper(middlegameScore, endgameScore, phase);
+#if defined(CHESS_DEBUG_EVAL)
+    // Built with -DCHESS_DEBUG_EVAL=ON, every evaluation is redone from
+    // scratch and the first mismatch stops the program
+    if (score != evaluateFromScratch()) {
+        std::cerr << "evaluate: incremental score " << score
+                  << " but recomputed " << evaluateFromScratch() << std::endl;
+        std::abort();
+    }
+#endif
+    return score;
+}
+
+int Position::evaluateFromScratch() const {
+    int middlegame = 0;
+    int endgame = 0;
+    int totalPhase = 0;
+    for (int piece = 0; piece < 12; ++piece) {
+        Bitboard bits = pieces[piece];
+        while (bits) {
+            const int square = popLsb(bits);
+            middlegame += pieceSquareMiddlegame[piece][square];
+            endgame += pieceSquareEndgame[piece][square];
+            totalPhase += piecePhase[piece];
+        }
+    }
+    return taper(middlegame, endgame, totalPhase);
+}
+
+bool Position::isSquareAttacked(int square, Color byColor) const {
+    return attackersTo(square, allPieces()) & occupancy[byColor];
+}
+
+bool Position::isKingInCheck(Color color) const {
+    const int king = kingSquare(color);
+    if (king == -1) {
+        return false;
+    }
+    return isSquareAttacked(king, color == WHITE ? BLACK : WHITE);
+}
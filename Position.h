@@ -0,0 +1,93 @@
+#ifndef POSITION_H
+#define POSITION_H
+
+#include <cstdint>
+#include <type_traits>
+#include "Bitboard.h"
+#include "Move.h"
+#include "MoveList.h"
+#include "Piece.h"
+
+// Bits of Position::castlingRights
+enum CastlingRight {
+    WHITE_KINGSIDE = 1,
+    WHITE_QUEENSIDE = 2,
+    BLACK_KINGSIDE = 4,
+    BLACK_QUEENSIDE = 8,
+};
+
+// Everything the search needs to know about a position and nothing more:
+// no history, no clocks, no pointers, no heap. It copies with a plain
+// memcpy, so the search plays each move on a fresh copy in a per-ply array
+// and taking the move back costs nothing. Board adds the move history, the
+// clocks and the text formats.
+class Position {
+   public:
+    // Plays move, which must be pseudo-legal for Us with Us to move, and
+    // returns the piece it captured. Nothing is recorded, so the only way
+    // back is a copy taken beforehand.
+    template <Color Us>
+    Piece applyMove(Move move);
+
+    void generateAllMoves(Color color, bool legal, MoveList& moves) const;
+    template <Color Us>
+    void generateAllMoves(bool legal, MoveList& moves) const;
+    // Size of the legal move list for color, counted without building it.
+    // Perft uses it for the last ply, where only the number matters.
+    int countLegalMoves(Color color) const;
+    template <Color Us>
+    int countLegalMoves() const;
+
+    // The piece on square, or NO_PIECE, read off the bitboards.
+    Piece pieceOn(int square) const;
+    Piece pieceAt(int x, int y) const { return pieceOn(makeSquare(x, y)); }
+    Bitboard allPieces() const {
+        return occupancy[WHITE] | occupancy[BLACK];
+    }
+    // Pieces of both colors attacking square, looked up in reverse from the
+    // square itself. occupied decides which sliders are blocked.
+    Bitboard attackersTo(int square, Bitboard occupied) const;
+    bool isSquareAttacked(int square, Color byColor) const;
+    bool isKingInCheck(Color color) const;
+    // Zobrist key built from scratch; key should always equal it.
+    uint64_t computeKey() const;
+
+    // Square of color's king, or -1 while it is off the board.
+    int kingSquare(Color color) const {
+        const Bitboard king = pieces[makePiece(color, KING)];
+        return king ? lsb(king) : -1;
+    }
+
+    // Material and piece-square score in centipawns from white's point of
+    // view, blended from middlegame to endgame by phase. Only reads the
+    // running totals below.
+    int evaluate() const;
+    // The same with the totals summed from scratch over the pieces;
+    // evaluate() should always equal it.
+    int evaluateFromScratch() const;
+
+    Bitboard pieces[12];  // indexed by Piece
+    Bitboard occupancy[2];
+    uint64_t key;  // Zobrist key, kept up to date by applyMove
+    // Sums of the pieces' pieceSquareMiddlegame and pieceSquareEndgame
+    // entries and of their piecePhase, kept up as pieces come and go
+    int16_t middlegameScore;
+    int16_t endgameScore;
+    uint8_t phase;
+    int8_t enPassantSquare;  // -1 when there is no en passant target
+    uint8_t castlingRights;  // CastlingRight bits still available
+    Color activeColor;
+
+   protected:
+    void putPiece(Piece piece, int square);
+    void removePiece(Piece piece, int square);
+    void movePiece(Piece piece, int from, int to);
+    void clearCastlingRights(int square);
+    uint64_t enPassantKey() const;
+};
+
+static_assert(std::is_trivially_copyable_v<Position>,
+              "Position must copy with memcpy");
+static_assert(sizeof(Position) <= 128, "Position must fit in 128 bytes");
+
+#endif  // POSITION_H
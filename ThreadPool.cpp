@@ -0,0 +1,61 @@
+#include "ThreadPool.h"
+
+ThreadPool::ThreadPool(int threads) : busy(0), stopping(false) {
+    if (threads <= 0) {
+        threads = static_cast<int>(std::thread::hardware_concurrency());
+    }
+    if (threads <= 0) {
+        threads = 1;
+    }
+    for (int i = 0; i < threads; ++i) {
+        workers.emplace_back(&ThreadPool::workerLoop, this, i);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    taskReady.notify_all();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+void ThreadPool::submit(std::function<void(int)> task) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        tasks.push_back(std::move(task));
+    }
+    taskReady.notify_one();
+}
+
+void ThreadPool::wait() {
+    std::unique_lock<std::mutex> lock(mutex);
+    allDone.wait(lock, [this] { return tasks.empty() && busy == 0; });
+}
+
+void ThreadPool::workerLoop(int index) {
+    while (true) {
+        std::function<void(int)> task;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            taskReady.wait(lock, [this] { return stopping || !tasks.empty(); });
+            if (tasks.empty()) {
+                return;
+            }
+            task = std::move(tasks.front());
+            tasks.pop_front();
+            ++busy;
+        }
+        task(index);
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            --busy;
+            if (tasks.empty() && busy == 0) {
+                allDone.notify_all();
+            }
+        }
+    }
+}
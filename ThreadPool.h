@@ -0,0 +1,37 @@
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed set of worker threads pulling tasks from one shared queue. Tasks
+// are handed the index of the worker running them, so callers can keep
+// per-thread results without locking.
+class ThreadPool {
+   public:
+    // 0 starts one worker per hardware thread
+    explicit ThreadPool(int threads = 0);
+    ~ThreadPool();
+
+    int size() const { return static_cast<int>(workers.size()); }
+    void submit(std::function<void(int)> task);
+    // Blocks until every submitted task has finished.
+    void wait();
+
+   private:
+    void workerLoop(int index);
+
+    std::vector<std::thread> workers;
+    std::deque<std::function<void(int)>> tasks;
+    std::mutex mutex;
+    std::condition_variable taskReady;
+    std::condition_variable allDone;
+    int busy;
+    bool stopping;
+};
+
+#endif  // THREADPOOL_H
@@ -0,0 +1,100 @@
+#include "TranspositionTable.h"
+#include <algorithm>
+
+TranspositionTable::TranspositionTable(size_t megabytes) : age(0) {
+    resize(megabytes);
+}
+
+void TranspositionTable::resize(size_t megabytes) {
+    size_t count = 1;
+    const size_t wanted = std::max<size_t>(megabytes, 1) * 1024 * 1024 /
+                          sizeof(Bucket);
+    while (count * 2 <= wanted) {
+        count *= 2;
+    }
+    buckets.assign(count, Bucket{});
+    age = 0;
+}
+
+void TranspositionTable::clear() {
+    std::fill(buckets.begin(), buckets.end(), Bucket{});
+    age = 0;
+}
+
+void TranspositionTable::newSearch() {
+    ++age;
+    stats = Stats();
+}
+
+bool TranspositionTable::probe(uint64_t key, Entry& entry) {
+    ++stats.probes;
+    const uint32_t fragment = static_cast<uint32_t>(key >> 32);
+    for (const Entry& candidate : bucketFor(key).entries) {
+        if (candidate.bound != NO_BOUND && candidate.key == fragment) {
+            ++stats.hits;
+            entry = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+void TranspositionTable::store(uint64_t key,
+                               int depth,
+                               int score,
+                               Bound bound,
+                               Move move) {
+    ++stats.stores;
+    const uint32_t fragment = static_cast<uint32_t>(key >> 32);
+    Entry* entries = bucketFor(key).entries;
+    const Entry fresh = {fragment,
+                         score,
+                         move,
+                         static_cast<int8_t>(depth),
+                         static_cast<uint8_t>(bound),
+                         age};
+
+    // The same position is refreshed in place, unless that would trade a
+    // deeper result from this search for a shallower bound
+    for (int i = 0; i < 4; ++i) {
+        Entry& entry = entries[i];
+        if (entry.bound == NO_BOUND || entry.key != fragment) {
+            continue;
+        }
+        if (depth >= entry.depth || bound == EXACT || entry.age != age) {
+            const Move previousMove = entry.move;
+            entry = fresh;
+            if (move.isNull()) {
+                entry.move = previousMove;
+            }
+        }
+        return;
+    }
+
+    // Of the two depth-preferred slots, give up the stale or shallower one
+    Entry* victim = &entries[0];
+    auto worth = [this](const Entry& entry) {
+        return entry.bound == NO_BOUND ? -256
+                                       : entry.depth - 8 * (entry.age != age);
+    };
+    if (worth(entries[1]) < worth(entries[0])) {
+        victim = &entries[1];
+    }
+    if (victim->bound == NO_BOUND || victim->age != age ||
+        depth >= victim->depth) {
+        *victim = fresh;
+    } else {
+        entries[2 + (fragment & 1)] = fresh;
+    }
+}
+
+int TranspositionTable::hashfull() const {
+    const size_t sample = std::min<size_t>(buckets.size(), 250);
+    int used = 0;
+    for (size_t i = 0; i < sample; ++i) {
+        for (const Entry& entry : buckets[i].entries) {
+            used += entry.bound != NO_BOUND && entry.age == age;
+        }
+    }
+    return static_cast<int>(used * 1000 / (sample * 4));
+}
@@ -0,0 +1,70 @@
+#ifndef TRANSPOSITIONTABLE_H
+#define TRANSPOSITIONTABLE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "Move.h"
+
+// Fixed-size hash table of search results keyed by Board::key. Each bucket
+// is one 64-byte cache line with four entries: two depth-preferred slots
+// that keep the deepest recent result, and two always-replace slots that
+// take whatever the depth-preferred ones turn away.
+class TranspositionTable {
+   public:
+    static const size_t DEFAULT_MB = 16;
+
+    enum Bound : uint8_t { NO_BOUND, EXACT, LOWER, UPPER };
+
+    struct Entry {
+        uint32_t key;  // upper half of the Zobrist key
+        int32_t score;
+        Move move;  // best or refuting move, null if none
+        int8_t depth;
+        uint8_t bound;
+        uint8_t age;
+    };
+
+    struct Stats {
+        unsigned long long probes = 0;
+        unsigned long long hits = 0;
+        unsigned long long cutoffs = 0;  // counted by the search
+        unsigned long long stores = 0;
+    };
+
+    explicit TranspositionTable(size_t megabytes = DEFAULT_MB);
+
+    // Rounds down to a power-of-two number of buckets and clears the table.
+    void resize(size_t megabytes);
+    void clear();
+    // Starts a new search: entries from earlier searches become the first
+    // to be replaced, and the stats start from zero.
+    void newSearch();
+
+    // Copies the entry for key into entry and returns true if there is one.
+    bool probe(uint64_t key, Entry& entry);
+    void store(uint64_t key, int depth, int score, Bound bound, Move move);
+
+    size_t bucketCount() const { return buckets.size(); }
+    // Permille of sampled entries written during the current search
+    int hashfull() const;
+
+    Stats stats;
+
+   private:
+    struct alignas(64) Bucket {
+        Entry entries[4];
+    };
+
+    Bucket& bucketFor(uint64_t key) {
+        return buckets[key & (buckets.size() - 1)];
+    }
+
+    std::vector<Bucket> buckets;
+    uint8_t age;
+};
+
+static_assert(sizeof(TranspositionTable::Entry) == 16,
+              "Four entries must fill one cache line");
+
+#endif  // TRANSPOSITIONTABLE_H
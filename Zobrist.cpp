@@ -0,0 +1,60 @@
+#include "Zobrist.h"
+
+namespace {
+
+struct ZobristKeys {
+    std::array<std::array<uint64_t, 64>, 12> pieces;
+    std::array<uint64_t, 16> castling;
+    std::array<uint64_t, 8> enPassant;
+    uint64_t side;
+};
+
+// splitmix64, which spreads even a simple seed over all 64 bits
+constexpr uint64_t nextKey(uint64_t& state) {
+    uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+constexpr ZobristKeys makeKeys() {
+    ZobristKeys keys{};
+    uint64_t state = 1070372;
+    for (auto& squares : keys.pieces) {
+        for (auto& key : squares) {
+            key = nextKey(state);
+        }
+    }
+    // One key per right; a mask hashes as the XOR of its rights, so losing
+    // a right is always the same XOR and no rights at all hashes to 0
+    uint64_t rights[4] = {};
+    for (auto& key : rights) {
+        key = nextKey(state);
+    }
+    for (int mask = 0; mask < 16; ++mask) {
+        for (int right = 0; right < 4; ++right) {
+            if (mask & (1 << right)) {
+                keys.castling[mask] ^= rights[right];
+            }
+        }
+    }
+    for (auto& key : keys.enPassant) {
+        key = nextKey(state);
+    }
+    keys.side = nextKey(state);
+    return keys;
+}
+
+constexpr ZobristKeys KEYS = makeKeys();
+
+}  // namespace
+
+constexpr std::array<std::array<uint64_t, 64>, 12> zobristPieceKeys =
+    KEYS.pieces;
+constexpr std::array<uint64_t, 16> zobristCastlingKeys = KEYS.castling;
+constexpr std::array<uint64_t, 8> zobristEnPassantKeys = KEYS.enPassant;
+constexpr uint64_t zobristSideKey = KEYS.side;
+
+static_assert(zobristCastlingKeys[0] == 0);
+static_assert(zobristCastlingKeys[15] ==
+              (zobristCastlingKeys[3] ^ zobristCastlingKeys[12]));
@@ -0,0 +1,16 @@
+#ifndef ZOBRIST_H
+#define ZOBRIST_H
+
+#include <array>
+#include <cstdint>
+
+// Random keys XORed together into Position::key: one per piece on each square,
+// one for black to move, one per castling-rights mask and one per en
+// passant file. Generated at compile time from a fixed seed, so a position
+// has the same key on every run.
+extern const std::array<std::array<uint64_t, 64>, 12> zobristPieceKeys;
+extern const std::array<uint64_t, 16> zobristCastlingKeys;
+extern const std::array<uint64_t, 8> zobristEnPassantKeys;
+extern const uint64_t zobristSideKey;
+
+#endif  // ZOBRIST_H
@@ -3,6 +3,7 @@
 #include <limits>
 #include "Board.h"
 #include "Minimax.h"
+#include "Nnue.h"
 // #include "testing/perfts/perftTester.h"
 
 void testToFEN() {
@@ -17,7 +18,7 @@ void testToFEN() {
 void testUnmakeMove() {
     Board board;
     Board originalBoard = board;
-    Move move = Move(1, 1, 1, 3, std::make_shared<Pawn>(WHITE));
+    Move move = board.moveFromUCI("b2b4");
     board.makeMove(move);
     board.display();
     board.unmakeMove(move);
@@ -56,10 +57,8 @@ void testMoveGeneration() {
 void printAllMovesForFEN(const std::string& fen) {
     Board board;
     board.loadFEN(fen);
-    std::cout << board.whiteKingMoved << " " << board.blackKingMoved << " "
-              << board.whiteRookMoved[0] << " " << board.whiteRookMoved[1]
-              << " " << board.blackRookMoved[0] << " "
-              << board.blackRookMoved[1] << std::endl;
+    std::cout << "castling rights " << int(board.castlingRights)
+              << std::endl;
     board.display();
     int totalMoves = 0;
     for (const auto& move : board.generateAllMoves(board.activeColor, true)) {
@@ -116,6 +115,10 @@ int main() {
     //     return 1;
     // }
 
+    if (Nnue::load(Nnue::DEFAULT_FILE)) {
+        std::cout << "Using network " << Nnue::DEFAULT_FILE << std::endl;
+    }
+
     // Start the game
     Board board;
     board.display();
@@ -143,11 +146,22 @@ int main() {
             continue;
         }
 
-        if (board.makeMove(Move(startX, startY, endX, endY,
-                                board.squares[startY][startX]))) {
+        // Pick the legal move between the two squares; promotions come
+        // queen first
+        Move move;
+        for (const auto& candidate :
+             board.generateAllMoves(board.activeColor, true)) {
+            if (candidate.from() == makeSquare(startX, startY) &&
+                candidate.to() == makeSquare(endX, endY)) {
+                move = candidate;
+                break;
+            }
+        }
+
+        if (!move.isNull() && board.makeMove(move)) {
             board.display();
             std::cout << "AI is making a move..." << std::endl;
-            if (board.makeAIMove(BLACK)) {
+            if (board.makeAIMove(BLACK, Board::AI_MOVETIME, true)) {
                 board.display();
             } else {
                 std::cout << "AI has no valid moves!" << std::endl;
@@ -5,6 +5,7 @@
 #include <map>
 #include <vector>
 #include "Board.h"
+#include "Nnue.h"
 
 const int TILE_SIZE = 50;
 const int BOARD_SIZE = 8;
@@ -45,7 +46,7 @@ class ChessGUI {
 
                 // Highlight available moves
                 for (const auto& move : highlightedMoves) {
-                    if (move.endX == x && move.endY == y) {
+                    if (move.to() == makeSquare(x, y)) {
                         tile.setFillColor(sf::Color(200, 100, 100, 150));
                         window.draw(tile);
                     }
@@ -55,16 +56,14 @@ class ChessGUI {
     }
 
     void drawPieces() {
+        const auto squares = board.squares();
         for (int y = BOARD_SIZE - 1; y >= 0; --y) {
             for (int x = 0; x < BOARD_SIZE; ++x) {
-                if (board.squares[y][x]) {
-                    std::string pieceSymbol(1,
-                                            board.squares[y][x]->getSymbol());
-                    std::string pieceColor =
-                        board.squares[y][x]->getColor() == WHITE ? "white"
-                                                                 : "black";
-                    sf::Sprite pieceSprite(
-                        textures[pieceColor + "_" + pieceSymbol]);
+                if (squares[y][x] != NO_PIECE) {
+                    std::string symbol(1, pieceSymbol(squares[y][x]));
+                    std::string color =
+                        pieceColor(squares[y][x]) == WHITE ? "white" : "black";
+                    sf::Sprite pieceSprite(textures[color + "_" + symbol]);
                     pieceSprite.setPosition(
                         {x * TILE_SIZE, (7 - y) * TILE_SIZE});
                     pieceSprite.setScale(
@@ -78,8 +77,8 @@ class ChessGUI {
 
     void trySelectSquare(int x, int y) {
         const Color activeColor = board.activeColor;
-        if (!board.squares[y][x] ||
-            board.squares[y][x]->getColor() != activeColor) {
+        if (board.pieceAt(x, y) == NO_PIECE ||
+            pieceColor(board.pieceAt(x, y)) != activeColor) {
             return;
         }
 
@@ -107,16 +106,16 @@ class ChessGUI {
         char selectedPromotion;
         bool wasMoveMade = false;
         for (const auto& move : highlightedMoves) {
-            if (move.endX != boardX || move.endY != boardY) {
+            if (move.to() != makeSquare(boardX, boardY)) {
                 continue;
             }
 
-            if (move.type == PROMOTION) {
+            if (move.type() == PROMOTION) {
                 // Open a promotion dialog
                 sf::RenderWindow promotionWindow(sf::VideoMode({200u, 50u}),
                                                  "Promotion");
                 std::vector<std::string> promotionPieces =
-                    move.promotionPiece->getColor() == WHITE
+                    board.activeColor == WHITE
                         ? std::vector<std::string>{"white_Q", "white_R",
                                                    "white_N", "white_B"}
                         : std::vector<std::string>{"black_Q", "black_R",
@@ -157,7 +156,9 @@ class ChessGUI {
                     promotionWindow.display();
                 }
 
-                if (move.promotionPiece->getSymbol() != selectedPromotion) {
+                // The dialog names end in the uppercase symbol for both colors
+                if (pieceSymbol(makePiece(WHITE, move.promotionType())) !=
+                    selectedPromotion) {
                     continue;
                 }
             }
@@ -221,6 +222,9 @@ class ChessGUI {
 
 int main() {
     std::cout << "Running Chess GUI..." << std::endl;
+    if (Nnue::load(Nnue::DEFAULT_FILE)) {
+        std::cout << "Using network " << Nnue::DEFAULT_FILE << std::endl;
+    }
 
     ChessGUI gui;
     gui.run();
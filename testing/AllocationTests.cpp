@@ -0,0 +1,57 @@
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include "Board.h"
+#include "MoveList.h"
+#include "catch2/catch_test_macros.hpp"
+
+// Every heap allocation in the test binary goes through here, so a test can
+// compare the count before and after the code it measures.
+static std::atomic<size_t> allocationCount{0};
+
+void* operator new(std::size_t size) {
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    if (void* memory = std::malloc(size ? size : 1)) {
+        return memory;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* memory) noexcept {
+    std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept {
+    std::free(memory);
+}
+
+static unsigned long long walk(Board& board, int depth) {
+    MoveList moves;
+    board.generateAllMoves(board.activeColor, true, moves);
+    if (depth == 1) {
+        return moves.size();
+    }
+
+    unsigned long long nodes = 0;
+    for (const auto& move : moves) {
+        board.makeMove(move);
+        nodes += walk(board, depth - 1);
+        board.unmakeMove(move);
+    }
+    return nodes;
+}
+
+TEST_CASE("make/generate/unmake does not allocate") {
+    Board board;
+    board.loadFEN(
+        "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 "
+        "1");
+
+    // The history is preallocated, so not even the first walk allocates
+    const size_t before = allocationCount.load();
+    const unsigned long long nodes = walk(board, 3);
+    const size_t after = allocationCount.load();
+
+    REQUIRE(nodes == 97862);
+    REQUIRE(after - before == 0);
+}
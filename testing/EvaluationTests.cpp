@@ -0,0 +1,114 @@
+#include <string>
+#include <vector>
+#include "Board.h"
+#include "Evaluation.h"
+#include "Minimax.h"
+#include "MoveList.h"
+#include "Position.h"
+#include "catch2/catch_test_macros.hpp"
+
+static void collectPositions(const Position& position,
+                             int depth,
+                             std::vector<Position>& positions) {
+    positions.push_back(position);
+    if (depth == 0) {
+        return;
+    }
+    MoveList moves;
+    position.generateAllMoves(position.activeColor, true, moves);
+    for (const auto& move : moves) {
+        Position child = position;
+        if (position.activeColor == WHITE) {
+            child.applyMove<WHITE>(move);
+        } else {
+            child.applyMove<BLACK>(move);
+        }
+        collectPositions(child, depth - 1, positions);
+    }
+}
+
+static int evaluateFen(const std::string& fen) {
+    Board board;
+    board.loadFEN(fen);
+    return Evaluation::evaluate(board);
+}
+
+TEST_CASE("Evaluation::evaluateBatch matches evaluate on every kernel") {
+    const std::vector<std::string> FENS = {
+        "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+        "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+        "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+    };
+    std::vector<Position> positions;
+    for (const auto& fen : FENS) {
+        Board board;
+        board.loadFEN(fen);
+        collectPositions(board, 2, positions);
+    }
+    // Not a multiple of any lane count, so the leftovers are covered too
+    positions.push_back(positions.front());
+    if (positions.size() % 8 == 0) {
+        positions.pop_back();
+    }
+
+    std::vector<int> expected(positions.size());
+    for (size_t i = 0; i < positions.size(); ++i) {
+        expected[i] = Evaluation::evaluate(positions[i]);
+    }
+    const Evaluation::Kernel bestKernel = Evaluation::kernel();
+    for (auto kernel :
+         {Evaluation::SCALAR, Evaluation::AVX2, Evaluation::AVX512}) {
+        if (!Evaluation::setKernel(kernel)) {
+            continue;
+        }
+        std::vector<int> scores(positions.size());
+        Evaluation::evaluateBatch(positions, scores);
+        REQUIRE(scores == expected);
+    }
+    Evaluation::setKernel(bestKernel);
+
+    std::vector<int> scores(positions.size());
+    Minimax::evaluateBatch(positions, scores);
+    REQUIRE(scores == expected);
+}
+
+TEST_CASE("Evaluation scores pawn structure") {
+    // The same material each time, only the white pawns move
+    const int connected = evaluateFen("4k3/8/8/8/8/8/3PP3/4K3 w - - 0 1");
+    const int doubled = evaluateFen("4k3/8/8/8/8/4P3/4P3/4K3 w - - 0 1");
+    const int isolated = evaluateFen("4k3/8/8/8/8/8/2P1P3/4K3 w - - 0 1");
+    REQUIRE(doubled < connected);
+    REQUIRE(isolated < connected);
+
+    // A passed pawn is worth more the closer it is to promoting, and more
+    // than one an enemy pawn stands in front of
+    const int far = evaluateFen("4k3/p7/8/8/8/8/4P3/4K3 w - - 0 1");
+    const int near = evaluateFen("4k3/p7/4P3/8/8/8/8/4K3 w - - 0 1");
+    const int blocked = evaluateFen("4k3/3p4/4P3/8/8/8/8/4K3 w - - 0 1");
+    REQUIRE(far < near);
+    REQUIRE(blocked < near);
+}
+
+TEST_CASE("Evaluation caches the pawn terms of each pawn structure") {
+    Board board;
+    board.loadFEN(
+        "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1");
+    std::vector<Position> positions;
+    collectPositions(board, 2, positions);
+
+    PawnHashTable& table = Evaluation::pawnTable();
+    table.clear();
+    std::vector<int> first;
+    for (const auto& position : positions) {
+        first.push_back(Evaluation::evaluate(position));
+    }
+    // Most moves leave the pawns alone
+    REQUIRE(table.stats.probes == positions.size());
+    REQUIRE(table.stats.hits > positions.size() / 2);
+
+    // Hits and misses give the same scores
+    table.clear();
+    for (size_t i = positions.size(); i-- > 0;) {
+        REQUIRE(Evaluation::evaluate(positions[i]) == first[i]);
+    }
+}
@@ -1,4 +1,8 @@
+#include <cctype>
+#include <chrono>
 #include <limits>
+#include <string>
+#include <vector>
 #include "Board.h"
 #include "Minimax.h"
 #include "Move.h"
@@ -10,6 +14,40 @@ TEST_CASE("Minimax::evaluateBoard") {
     REQUIRE(score == 0);  // Initial board should have a score of 0
 }
 
+// The same position with the colors swapped and the board flipped
+static std::string mirrorPlacement(const std::string& placement) {
+    std::vector<std::string> ranks(1);
+    for (char c : placement) {
+        if (c == '/') {
+            ranks.emplace_back();
+        } else {
+            ranks.back() += std::isupper(c) ? std::tolower(c)
+                                            : std::toupper(c);
+        }
+    }
+    std::string mirrored;
+    for (auto rank = ranks.rbegin(); rank != ranks.rend(); ++rank) {
+        mirrored += (mirrored.empty() ? "" : "/") + *rank;
+    }
+    return mirrored;
+}
+
+TEST_CASE("Minimax::evaluateBoard does not favor a color") {
+    const std::vector<std::string> PLACEMENTS = {
+        "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R",
+        "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8",
+        "6k1/6p1/6Pp/ppp5/3pn2P/1P3K2/1PP2P2/8",
+    };
+    for (const auto& placement : PLACEMENTS) {
+        Board board;
+        board.loadFEN(placement + " w - - 0 1");
+        Board mirrored;
+        mirrored.loadFEN(mirrorPlacement(placement) + " b - - 0 1");
+        REQUIRE(Minimax::evaluateBoard(board, WHITE) ==
+                Minimax::evaluateBoard(mirrored, BLACK));
+    }
+}
+
 TEST_CASE("Minimax::findBestMove alphaBeta is same as minimax") {
     const std::vector<std::string> FENS = {
         "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
@@ -93,9 +131,50 @@ TEST_CASE("Minimax::findBestMove alphaBeta is same as minimax") {
             Minimax::findBestMove(board, board.activeColor, 3, false);
         Move alphaBetaMove =
             Minimax::findBestMove(board, board.activeColor, 3, true);
-        REQUIRE(minimaxMove.startX == alphaBetaMove.startX);
-        REQUIRE(minimaxMove.startY == alphaBetaMove.startY);
-        REQUIRE(minimaxMove.endX == alphaBetaMove.endX);
-        REQUIRE(minimaxMove.endY == alphaBetaMove.endY);
+        REQUIRE(minimaxMove.toUCI() == alphaBetaMove.toUCI());
+    }
+}
+
+TEST_CASE("Minimax::iterativeDeepening finds a mate with a depth limit") {
+    Board board;
+    board.loadFEN("6k1/5ppp/8/8/8/8/5PPP/3R2K1 w - - 0 1");
+    Minimax::SearchLimits limits;
+    limits.depth = 3;
+    REQUIRE(Minimax::iterativeDeepening(board, WHITE, limits).toUCI() ==
+            "d1d8");
+}
+
+TEST_CASE("Minimax::iterativeDeepening keeps to its time") {
+    using Clock = std::chrono::steady_clock;
+    const std::string FEN =
+        "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1";
+    Board board;
+    board.loadFEN(FEN);
+
+    // A fixed time per move, and a share of a clock: 2000 ms over the
+    // default 30 moves to go gives 3 * 66 ms at most. The margin is for a
+    // busy machine.
+    Minimax::SearchLimits movetime;
+    movetime.movetime = 200;
+    Minimax::SearchLimits clock;
+    clock.time[WHITE] = 2000;
+    for (const auto& limits : {movetime, clock}) {
+        const auto start = Clock::now();
+        const Move move = Minimax::iterativeDeepening(board, WHITE, limits);
+        const auto elapsed = Clock::now() - start;
+        REQUIRE(elapsed < std::chrono::milliseconds(200 + 300));
+        REQUIRE(board.moveFromUCI(move.toUCI()) == move);
     }
-}
\ No newline at end of file
+
+    // Even without time for the first iteration there is a legal move
+    Minimax::SearchLimits instant;
+    instant.movetime = 1;
+    const Move move = Minimax::iterativeDeepening(board, WHITE, instant);
+    REQUIRE(board.moveFromUCI(move.toUCI()) == move);
+
+    // Without any limit the default time applies
+    const auto start = Clock::now();
+    Minimax::iterativeDeepening(board, WHITE, Minimax::SearchLimits());
+    REQUIRE(Clock::now() - start <
+            std::chrono::milliseconds(Minimax::DEFAULT_MOVETIME + 300));
+}
@@ -0,0 +1,144 @@
+#include <algorithm>
+#include <string>
+#include <vector>
+#include "Board.h"
+#include "MoveGen.h"
+#include "MovePicker.h"
+#include "catch2/catch_test_macros.hpp"
+
+static const std::vector<std::string> PICKER_FENS = {
+    "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+    "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+    "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+    "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+    "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8",
+    "8/8/8/2k5/3Pp3/8/8/4K3 b - d3 0 1",
+};
+
+static bool contains(const std::vector<Move>& moves, Move move) {
+    return std::find(moves.begin(), moves.end(), move) != moves.end();
+}
+
+static std::vector<std::string> sortedUCI(const std::vector<Move>& moves) {
+    std::vector<std::string> uci;
+    for (const auto& move : moves) {
+        uci.push_back(move.toUCI());
+    }
+    std::sort(uci.begin(), uci.end());
+    return uci;
+}
+
+// Positions within depth plies of every test FEN, and every move seen in
+// any of them to stand in for hash moves and killers from elsewhere
+static void collect(Board& board,
+                    int depth,
+                    std::vector<std::string>& fens,
+                    std::vector<Move>& pool) {
+    fens.push_back(board.toFEN());
+    MoveList moves;
+    board.generateAllMoves(board.activeColor, true, moves);
+    for (const auto& move : moves) {
+        if (!contains(pool, move)) {
+            pool.push_back(move);
+        }
+        if (depth > 0) {
+            board.makeMove(move);
+            collect(board, depth - 1, fens, pool);
+            board.unmakeMove(move);
+        }
+    }
+}
+
+template <Color Us>
+static void checkPicker(Board& board,
+                        bool legal,
+                        const std::vector<Move>& pool,
+                        size_t& seed) {
+    const std::vector<Move> expected = board.generateAllMoves(Us, legal);
+    const Move hashMove = pool[seed++ % pool.size()];
+    const Move killers[2] = {pool[seed++ % pool.size()],
+                             pool[seed++ % pool.size()]};
+
+    MovePicker<Us> picker(board, legal, hashMove, killers);
+    std::vector<Move> picked;
+    for (Move move = picker.next(); !move.isNull(); move = picker.next()) {
+        picked.push_back(move);
+    }
+    REQUIRE(sortedUCI(picked) == sortedUCI(expected));
+    if (contains(expected, hashMove)) {
+        REQUIRE(picked.front() == hashMove);
+    }
+
+    // The validators must agree with the generators on foreign moves
+    for (const auto& move : pool) {
+        const bool valid =
+            MoveGen::isPseudoLegal<Us>(board, move) &&
+            (!legal || MoveGen::isLegal<Us>(board, move));
+        REQUIRE(valid == contains(expected, move));
+    }
+
+    std::vector<Move> noisy;
+    for (const auto& move : expected) {
+        if (board.pieceOn(move.to()) != NO_PIECE ||
+            move.type() == EN_PASSANT || move.type() == PROMOTION) {
+            noisy.push_back(move);
+        }
+    }
+    MovePicker<Us> capturesOnly(board, legal);
+    picked.clear();
+    for (Move move = capturesOnly.next(); !move.isNull();
+         move = capturesOnly.next()) {
+        picked.push_back(move);
+    }
+    REQUIRE(sortedUCI(picked) == sortedUCI(noisy));
+}
+
+TEST_CASE("MovePicker hands out every move exactly once") {
+    std::vector<std::string> fens;
+    std::vector<Move> pool;
+    for (const auto& fen : PICKER_FENS) {
+        Board board;
+        board.loadFEN(fen);
+        collect(board, 1, fens, pool);
+    }
+
+    size_t seed = 0;
+    for (const auto& fen : fens) {
+        Board board;
+        board.loadFEN(fen);
+        for (bool legal : {true, false}) {
+            if (board.activeColor == WHITE) {
+                checkPicker<WHITE>(board, legal, pool, seed);
+            } else {
+                checkPicker<BLACK>(board, legal, pool, seed);
+            }
+        }
+    }
+}
+
+TEST_CASE("MovePicker orders captures by victim, then attacker") {
+    Board board;
+    // The queen on d5 can be taken by the pawn or the knight; the rook on
+    // a7 only by the bishop
+    board.loadFEN("4k3/r7/8/3q4/4P3/2N5/8/4K1B1 w - - 0 1");
+    const Move none[2];
+    MovePicker<WHITE> picker(board, true, Move(), none);
+    REQUIRE(picker.next().toUCI() == "e4d5");
+    REQUIRE(picker.next().toUCI() == "c3d5");
+    REQUIRE(picker.next().toUCI() == "g1a7");
+}
+
+TEST_CASE("MovePicker::see follows the exchange") {
+    Board board;
+    board.loadFEN("4k3/8/8/3p4/4P3/8/8/4K3 w - - 0 1");
+    REQUIRE(MovePicker<WHITE>::see(board, board.moveFromUCI("e4d5")) == 1);
+
+    board.loadFEN("4k3/8/2p5/3p4/8/8/8/3RK3 w - - 0 1");
+    REQUIRE(MovePicker<WHITE>::see(board, board.moveFromUCI("d1d5")) == -4);
+
+    // The rook behind the capturer joins in once the first one has gone
+    board.loadFEN("3rk3/8/8/3r4/8/8/3R4/3RK3 w - - 0 1");
+    REQUIRE(MovePicker<WHITE>::see(board, board.moveFromUCI("d2d5")) == 5);
+    board.loadFEN("3rk3/8/8/3r4/8/8/3R4/4K3 w - - 0 1");
+    REQUIRE(MovePicker<WHITE>::see(board, board.moveFromUCI("d2d5")) == 0);
+}
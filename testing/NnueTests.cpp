@@ -0,0 +1,162 @@
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+#include "Board.h"
+#include "Minimax.h"
+#include "MoveList.h"
+#include "Nnue.h"
+#include "Position.h"
+#include "RandomNetwork.h"
+#include "catch2/catch_test_macros.hpp"
+
+static const std::vector<std::string> NNUE_FENS = {
+    "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+    "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+    "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+};
+
+static std::string networkPath(const std::string& name) {
+    return (std::filesystem::temp_directory_path() / name).string();
+}
+
+static bool sameAccumulator(const Nnue::Accumulator& a,
+                            const Nnue::Accumulator& b) {
+    return std::memcmp(&a, &b, sizeof(Nnue::Accumulator)) == 0;
+}
+
+// Every kernel the CPU has must agree with the scalar one
+static int checkedEvaluate(const Nnue::Accumulator& accumulator, Color side) {
+    REQUIRE(Nnue::setKernel(Nnue::SCALAR));
+    const int expected = Nnue::evaluate(accumulator, side);
+    for (Nnue::Kernel kernel : {Nnue::SSE41, Nnue::AVX2}) {
+        if (Nnue::setKernel(kernel)) {
+            REQUIRE(Nnue::evaluate(accumulator, side) == expected);
+        }
+    }
+    return expected;
+}
+
+static void checkUpdates(const Position& position,
+                         const Nnue::Accumulator& accumulator,
+                         int depth) {
+    Nnue::Accumulator refreshed;
+    Nnue::refresh(position, refreshed);
+    REQUIRE(sameAccumulator(refreshed, accumulator));
+    checkedEvaluate(accumulator, position.activeColor);
+    if (depth == 0) {
+        return;
+    }
+
+    MoveList moves;
+    position.generateAllMoves(position.activeColor, true, moves);
+    for (const auto& move : moves) {
+        Position child = position;
+        if (position.activeColor == WHITE) {
+            child.applyMove<WHITE>(move);
+        } else {
+            child.applyMove<BLACK>(move);
+        }
+        Nnue::Accumulator childAccumulator;
+        Nnue::update(position, accumulator, child, childAccumulator);
+        checkUpdates(child, childAccumulator, depth - 1);
+    }
+}
+
+TEST_CASE("Nnue::load only accepts network files") {
+    REQUIRE_FALSE(Nnue::load(networkPath("missing-network.bin")));
+    REQUIRE_FALSE(Nnue::loaded());
+
+    const std::string path = networkPath("truncated-network.bin");
+    std::ofstream(path, std::ios::binary) << "CHESSNN1";
+    REQUIRE_FALSE(Nnue::load(path));
+    REQUIRE_FALSE(Nnue::loaded());
+    std::filesystem::remove(path);
+
+    // Output weights this large could overflow the output sum
+    const std::string largePath = networkPath("large-network.bin");
+    REQUIRE(writeRandomNetwork(largePath, 1));
+    std::fstream file(largePath,
+                      std::ios::binary | std::ios::in | std::ios::out);
+    file.seekp(64 + (size_t(Nnue::INPUTS) + 1) * Nnue::HIDDEN *
+                        sizeof(int16_t));
+    const std::vector<int16_t> large(2 * Nnue::HIDDEN, INT16_MAX);
+    file.write(reinterpret_cast<const char*>(large.data()),
+               large.size() * sizeof(int16_t));
+    file.close();
+    REQUIRE_FALSE(Nnue::load(largePath));
+    REQUIRE_FALSE(Nnue::loaded());
+    std::filesystem::remove(largePath);
+}
+
+TEST_CASE("Nnue accumulator updates match a refresh on every kernel") {
+    const std::string path = networkPath("random-network.bin");
+    REQUIRE(writeRandomNetwork(path, 1));
+    REQUIRE(Nnue::load(path));
+
+    for (const auto& fen : NNUE_FENS) {
+        Board board;
+        board.loadFEN(fen);
+        Nnue::Accumulator accumulator;
+        Nnue::refresh(board, accumulator);
+        checkUpdates(board, accumulator, 2);
+    }
+
+    // The search evaluates through the accumulators it carries along
+    Board board;
+    board.loadFEN(NNUE_FENS[0]);
+    const Move best = Minimax::findBestMove(board, WHITE, 3, true);
+    REQUIRE(best == board.moveFromUCI(best.toUCI()));
+
+    // Its scores came from the network and mean nothing to later searches
+    Minimax::table.clear();
+    Nnue::unload();
+    REQUIRE_FALSE(Nnue::loaded());
+    std::filesystem::remove(path);
+}
+
+TEST_CASE("Nnue evaluation does not favor a color") {
+    const std::string path = networkPath("random-network.bin");
+    REQUIRE(writeRandomNetwork(path, 2));
+    REQUIRE(Nnue::load(path));
+
+    // The black-to-move mirror image of each position, spelled out
+    const std::vector<std::pair<std::string, std::string>> PAIRS = {
+        {"8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+         "8/4p1p1/8/1r3P1K/kp5R/3P4/2P5/8 b - - 0 1"},
+        {"4k3/r7/8/3q4/4P3/2N5/8/4K1B1 w - - 0 1",
+         "4k1b1/8/2n5/4p3/3Q4/8/R7/4K3 b - - 0 1"},
+    };
+    for (const auto& [fen, mirrored] : PAIRS) {
+        Board board;
+        board.loadFEN(fen);
+        Board mirror;
+        mirror.loadFEN(mirrored);
+        REQUIRE(Minimax::evaluateBoard(board, WHITE) ==
+                Minimax::evaluateBoard(mirror, BLACK));
+    }
+
+    Nnue::unload();
+    std::filesystem::remove(path);
+}
+
+TEST_CASE("Nnue search sees a king capture as decisive") {
+    const std::string path = networkPath("random-network.bin");
+    REQUIRE(writeRandomNetwork(path, 1));
+    REQUIRE(Nnue::load(path));
+
+    // The network knows nothing of mate, but the search still finds the
+    // back-rank one
+    Board board;
+    board.loadFEN("6k1/5ppp/8/8/8/8/5PPP/3R2K1 w - - 0 1");
+    Minimax::SearchLimits limits;
+    limits.depth = 3;
+    REQUIRE(Minimax::iterativeDeepening(board, WHITE, limits).toUCI() ==
+            "d1d8");
+    REQUIRE(Minimax::findBestMove(board, WHITE, 3, true).toUCI() == "d1d8");
+
+    Minimax::table.clear();
+    Nnue::unload();
+    std::filesystem::remove(path);
+}
@@ -0,0 +1,95 @@
+#include <cstring>
+#include <string>
+#include <vector>
+#include "Board.h"
+#include "MoveList.h"
+#include "Position.h"
+#include "catch2/catch_test_macros.hpp"
+
+static bool samePosition(const Position& a, const Position& b) {
+    return std::memcmp(&a, &b, sizeof(Position)) == 0;
+}
+
+// Plays every move both ways, applyMove on a copy and makeMove on the board,
+// and requires the two to agree byte for byte, and unmakeMove to restore the
+// copy it started from.
+static void checkCopyMake(Board& board, int depth) {
+    const Position parent = board;
+    MoveList moves;
+    board.generateAllMoves(board.activeColor, true, moves);
+    for (const auto& move : moves) {
+        Position child = parent;
+        if (parent.activeColor == WHITE) {
+            child.applyMove<WHITE>(move);
+        } else {
+            child.applyMove<BLACK>(move);
+        }
+        board.makeMove(move);
+        REQUIRE(samePosition(child, board));
+        REQUIRE(child.evaluate() == child.evaluateFromScratch());
+        if (depth > 1) {
+            checkCopyMake(board, depth - 1);
+        }
+        board.unmakeMove(move);
+        REQUIRE(samePosition(parent, board));
+    }
+}
+
+TEST_CASE("Copy-make and make/unmake reach the same positions") {
+    const std::vector<std::string> FENS = {
+        "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+        "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+        "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+    };
+    for (const auto& fen : FENS) {
+        Board board;
+        board.loadFEN(fen);
+        checkCopyMake(board, 3);
+    }
+}
+
+TEST_CASE("Position::pieceOn reads the bitboards") {
+    Board board;
+    board.loadFEN("4k3/8/8/3q4/4P3/2N5/8/4K1B1 w - - 0 1");
+    REQUIRE(board.pieceOn(makeSquare(4, 7)) == BLACK_KING);
+    REQUIRE(board.pieceOn(makeSquare(3, 4)) == BLACK_QUEEN);
+    REQUIRE(board.pieceOn(makeSquare(4, 3)) == WHITE_PAWN);
+    REQUIRE(board.pieceOn(makeSquare(2, 2)) == WHITE_KNIGHT);
+    REQUIRE(board.pieceOn(makeSquare(4, 0)) == WHITE_KING);
+    REQUIRE(board.pieceOn(makeSquare(6, 0)) == WHITE_BISHOP);
+    REQUIRE(board.pieceOn(makeSquare(0, 0)) == NO_PIECE);
+}
+
+TEST_CASE("Board::loadFEN defaults the move counters") {
+    const std::string PLACEMENT =
+        "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq -";
+    Board full;
+    full.loadFEN(PLACEMENT + " 0 1");
+    Board board;
+    board.loadFEN(PLACEMENT);
+    REQUIRE(samePosition(board, full));
+    REQUIRE(board.toFEN() == full.toFEN());
+}
+
+TEST_CASE("Board keeps the history of games longer than the undo stack") {
+    // Both sides shuffle their knights, running the halfmove clock far
+    // past what a byte holds
+    const std::string FEN = "4k1n1/8/8/8/8/8/8/1N2K3 w - - 300 1";
+    Board board;
+    board.loadFEN(FEN);
+    const std::vector<std::string> CYCLE = {"b1c3", "g8f6", "c3b1", "f6g8"};
+    std::vector<Move> played;
+    for (int ply = 0; ply < UndoStack::CAPACITY + 100; ++ply) {
+        const Move move = board.moveFromUCI(CYCLE[ply % CYCLE.size()]);
+        REQUIRE(!move.isNull());
+        board.makeMove(move);
+        played.push_back(move);
+    }
+    REQUIRE(board.halfmoveClock == 300 + UndoStack::CAPACITY + 100);
+
+    while (!played.empty()) {
+        board.unmakeMove(played.back());
+        played.pop_back();
+    }
+    REQUIRE(board.toFEN() == FEN);
+}
@@ -0,0 +1,45 @@
+#ifndef RANDOMNETWORK_H
+#define RANDOMNETWORK_H
+
+#include <cstdint>
+#include <fstream>
+#include <random>
+#include <string>
+#include <vector>
+#include "../Nnue.h"
+
+// Writes a network file in the layout Nnue::load expects, filled with
+// small random weights. Such a network plays nonsense, but it exercises
+// every input and is the same for the same seed.
+inline bool writeRandomNetwork(const std::string& path, uint32_t seed) {
+    std::mt19937 random(seed);
+    std::uniform_int_distribution<int> weight(-Nnue::QB, Nnue::QB);
+
+    std::vector<char> header(64, 0);
+    const std::string magic = "CHESSNN1";
+    std::copy(magic.begin(), magic.end(), header.begin());
+    const uint32_t hidden = Nnue::HIDDEN;
+    std::copy(reinterpret_cast<const char*>(&hidden),
+              reinterpret_cast<const char*>(&hidden) + sizeof(hidden),
+              header.begin() + magic.size());
+
+    std::vector<int16_t> weights(size_t(Nnue::INPUTS) * Nnue::HIDDEN +
+                                 Nnue::HIDDEN + 2 * Nnue::HIDDEN);
+    for (auto& value : weights) {
+        value = static_cast<int16_t>(weight(random));
+    }
+    std::vector<char> outputBias(64, 0);
+    const int32_t bias = weight(random) * Nnue::QA;
+    std::copy(reinterpret_cast<const char*>(&bias),
+              reinterpret_cast<const char*>(&bias) + sizeof(bias),
+              outputBias.begin());
+
+    std::ofstream file(path, std::ios::binary);
+    file.write(header.data(), header.size());
+    file.write(reinterpret_cast<const char*>(weights.data()),
+               weights.size() * sizeof(int16_t));
+    file.write(outputBias.data(), outputBias.size());
+    return bool(file);
+}
+
+#endif  // RANDOMNETWORK_H
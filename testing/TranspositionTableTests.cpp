@@ -0,0 +1,62 @@
+#include "TranspositionTable.h"
+#include "catch2/catch_test_macros.hpp"
+
+// Keys that share a bucket: same low bits, different upper halves
+static uint64_t keyInBucket0(uint32_t fragment) {
+    return static_cast<uint64_t>(fragment) << 32;
+}
+
+TEST_CASE("TranspositionTable sizes to a power of two") {
+    TranspositionTable table(1);
+    REQUIRE(table.bucketCount() == 1024 * 1024 / 64);
+    table.resize(3);
+    REQUIRE(table.bucketCount() == 2 * 1024 * 1024 / 64);
+}
+
+TEST_CASE("TranspositionTable stores and probes entries") {
+    TranspositionTable table(1);
+    TranspositionTable::Entry entry;
+    REQUIRE_FALSE(table.probe(keyInBucket0(1), entry));
+
+    table.store(keyInBucket0(1), 3, -42, TranspositionTable::LOWER,
+                Move(12, 28));
+    REQUIRE(table.probe(keyInBucket0(1), entry));
+    REQUIRE(entry.depth == 3);
+    REQUIRE(entry.score == -42);
+    REQUIRE(entry.bound == TranspositionTable::LOWER);
+    REQUIRE(entry.move == Move(12, 28));
+    REQUIRE_FALSE(table.probe(keyInBucket0(2), entry));
+
+    // A shallower bound for the same position keeps the deeper result
+    table.store(keyInBucket0(1), 1, 7, TranspositionTable::UPPER, Move());
+    REQUIRE(table.probe(keyInBucket0(1), entry));
+    REQUIRE(entry.depth == 3);
+    REQUIRE(table.stats.probes == 4);
+    REQUIRE(table.stats.hits == 2);
+}
+
+TEST_CASE("TranspositionTable keeps deep entries over shallow ones") {
+    TranspositionTable table(1);
+    TranspositionTable::Entry entry;
+    table.store(keyInBucket0(1), 6, 0, TranspositionTable::EXACT, Move());
+    table.store(keyInBucket0(2), 5, 0, TranspositionTable::EXACT, Move());
+
+    // Both depth-preferred slots hold deeper results, so shallow entries
+    // cycle through the always-replace slots
+    for (uint32_t fragment = 3; fragment < 10; ++fragment) {
+        table.store(keyInBucket0(fragment), 1, 0, TranspositionTable::EXACT,
+                    Move());
+    }
+    REQUIRE(table.probe(keyInBucket0(1), entry));
+    REQUIRE(table.probe(keyInBucket0(2), entry));
+    REQUIRE(table.probe(keyInBucket0(9), entry));
+
+    // Results from an earlier search give way to anything new
+    table.newSearch();
+    table.store(keyInBucket0(10), 1, 0, TranspositionTable::EXACT, Move());
+    table.store(keyInBucket0(11), 1, 0, TranspositionTable::EXACT, Move());
+    REQUIRE(table.probe(keyInBucket0(10), entry));
+    REQUIRE(table.probe(keyInBucket0(11), entry));
+    REQUIRE_FALSE(table.probe(keyInBucket0(1), entry));
+    REQUIRE_FALSE(table.probe(keyInBucket0(2), entry));
+}
@@ -0,0 +1,79 @@
+#include <string>
+#include <vector>
+#include "Board.h"
+#include "MoveList.h"
+#include "catch2/catch_test_macros.hpp"
+
+// Checks the incremental key against a full recomputation at every node,
+// and that unmakeMove hands back the key it started from.
+static void checkKeys(Board& board, int depth) {
+    REQUIRE(board.key == board.computeKey());
+    if (depth == 0) {
+        return;
+    }
+
+    MoveList moves;
+    board.generateAllMoves(board.activeColor, true, moves);
+    for (const auto& move : moves) {
+        const uint64_t before = board.key;
+        board.makeMove(move);
+        checkKeys(board, depth - 1);
+        board.unmakeMove(move);
+        REQUIRE(board.key == before);
+    }
+}
+
+static uint64_t keyAfter(const std::string& fen,
+                         const std::vector<std::string>& moves) {
+    Board board;
+    board.loadFEN(fen);
+    for (const auto& uci : moves) {
+        board.makeMove(board.moveFromUCI(uci));
+    }
+    return board.key;
+}
+
+TEST_CASE("Zobrist key is maintained by makeMove and unmakeMove") {
+    const std::vector<std::string> FENS = {
+        "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+        "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+        "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+    };
+    for (const auto& fen : FENS) {
+        Board board;
+        board.loadFEN(fen);
+        checkKeys(board, 3);
+    }
+}
+
+TEST_CASE("Zobrist key depends only on the position") {
+    const std::string START =
+        "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1";
+
+    // Transpositions meet on the same key
+    REQUIRE(keyAfter(START, {"g1f3", "g8f6", "b1c3"}) ==
+            keyAfter(START, {"b1c3", "g8f6", "g1f3"}));
+    REQUIRE(keyAfter(START, {"g1f3", "g8f6", "f3g1", "f6g8"}) ==
+            keyAfter(START, {}));
+
+    // Side to move and castling rights are part of the key
+    REQUIRE(keyAfter(START, {"g1f3"}) !=
+            keyAfter("rnbqkbnr/pppppppp/8/8/8/5N2/PPPPPPPP/RNBQKB1R w KQkq "
+                     "- 0 1",
+                     {}));
+    REQUIRE(keyAfter(START, {"g1f3", "g8f6", "h1g1", "f6g8", "g1h1",
+                             "g8f6"}) !=
+            keyAfter(START, {"g1f3", "g8f6"}));
+
+    // An en passant square only counts when it can be captured
+    REQUIRE(keyAfter(START, {"e2e4"}) ==
+            keyAfter("rnbqkbnr/pppppppp/8/8/4P3/8/PPPP1PPP/RNBQKBNR b KQkq - "
+                     "0 1",
+                     {}));
+    const std::string EN_PASSANT =
+        "rnbqkbnr/ppp1pppp/8/8/3p4/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1";
+    REQUIRE(keyAfter(EN_PASSANT, {"e2e4"}) !=
+            keyAfter("rnbqkbnr/ppp1pppp/8/8/3pP3/8/PPPP1PPP/RNBQKBNR b KQkq - "
+                     "0 1",
+                     {}));
+}
@@ -0,0 +1,106 @@
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "../../Board.h"
+#include "../../MoveList.h"
+
+// Times the same perft walk driven two ways: through the runtime-color
+// overloads, which look up the moving side on every call, and through the
+// color-templated ones, where the side is a template argument all the way
+// down the tree. Both must agree on the node counts.
+
+static unsigned long long runtimeWalk(Board& board, int depth) {
+    MoveList moves;
+    board.generateAllMoves(board.activeColor, true, moves);
+    if (depth == 1) {
+        return moves.size();
+    }
+
+    unsigned long long nodes = 0;
+    for (const auto& move : moves) {
+        board.makeMove(move);
+        nodes += runtimeWalk(board, depth - 1);
+        board.unmakeMove(move);
+    }
+    return nodes;
+}
+
+template <Color Us>
+static unsigned long long templatedWalk(Board& board, int depth) {
+    constexpr Color Them = Us == WHITE ? BLACK : WHITE;
+    MoveList moves;
+    board.generateAllMoves<Us>(true, moves);
+    if (depth == 1) {
+        return moves.size();
+    }
+
+    unsigned long long nodes = 0;
+    for (const auto& move : moves) {
+        board.makeMove<Us>(move);
+        nodes += templatedWalk<Them>(board, depth - 1);
+        board.unmakeMove<Us>(move);
+    }
+    return nodes;
+}
+
+template <typename Walk>
+static double bestSeconds(Board& board,
+                          int depth,
+                          Walk walk,
+                          unsigned long long& nodes) {
+    const int RUNS = 5;
+    double best = 0;
+    for (int run = 0; run < RUNS; ++run) {
+        auto start = std::chrono::steady_clock::now();
+        nodes = walk(board, depth);
+        std::chrono::duration<double> elapsed =
+            std::chrono::steady_clock::now() - start;
+        if (run == 0 || elapsed.count() < best) {
+            best = elapsed.count();
+        }
+    }
+    return best;
+}
+
+int main() {
+    const std::vector<std::pair<std::string, int>> POSITIONS = {
+        {"rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1", 5},
+        {"r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+         4},
+        {"8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1", 6},
+        {"r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1", 5},
+    };
+
+    double runtimeTotal = 0;
+    double templatedTotal = 0;
+    for (const auto& [fen, depth] : POSITIONS) {
+        Board board;
+        board.loadFEN(fen);
+
+        unsigned long long runtimeNodes = 0;
+        unsigned long long templatedNodes = 0;
+        double runtimeTime = bestSeconds(board, depth, runtimeWalk,
+                                         runtimeNodes);
+        double templatedTime = bestSeconds(
+            board, depth,
+            board.activeColor == WHITE ? templatedWalk<WHITE>
+                                       : templatedWalk<BLACK>,
+            templatedNodes);
+        if (runtimeNodes != templatedNodes) {
+            std::cerr << "Node counts differ for " << fen << std::endl;
+            return 1;
+        }
+        runtimeTotal += runtimeTime;
+        templatedTotal += templatedTime;
+
+        std::cout << fen << " depth " << depth << ": " << runtimeNodes
+                  << " nodes, runtime " << runtimeTime * 1000
+                  << " ms, templated " << templatedTime * 1000 << " ms"
+                  << std::endl;
+    }
+    std::cout << "Total: runtime " << runtimeTotal * 1000 << " ms, templated "
+              << templatedTotal * 1000 << " ms, speedup "
+              << runtimeTotal / templatedTotal << "x" << std::endl;
+    return 0;
+}
@@ -0,0 +1,120 @@
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "../../Board.h"
+#include "../../MoveList.h"
+#include "../../Position.h"
+
+// Times the same perft walk with the two ways of getting back to a parent:
+// Board's make/unmake, which records each move in the history and undoes it
+// piece by piece, and the search's copy-make, which plays each move on a
+// copy of the parent in a per-ply array and simply drops it afterwards.
+// Every leaf is played so the state handling is not hidden behind bulk
+// counting. Both must agree on the node counts.
+
+const int MAX_DEPTH = 8;
+
+template <Color Us>
+static unsigned long long makeUnmakeWalk(Board& board, int depth) {
+    constexpr Color Them = Us == WHITE ? BLACK : WHITE;
+    if (depth == 0) {
+        return 1;
+    }
+    MoveList moves;
+    board.generateAllMoves<Us>(true, moves);
+
+    unsigned long long nodes = 0;
+    for (const auto& move : moves) {
+        board.makeMove<Us>(move);
+        nodes += makeUnmakeWalk<Them>(board, depth - 1);
+        board.unmakeMove<Us>(move);
+    }
+    return nodes;
+}
+
+template <Color Us>
+static unsigned long long copyMakeWalk(Position* positions, int depth) {
+    constexpr Color Them = Us == WHITE ? BLACK : WHITE;
+    if (depth == 0) {
+        return 1;
+    }
+    const Position& position = positions[0];
+    Position& child = positions[1];
+    MoveList moves;
+    position.generateAllMoves<Us>(true, moves);
+
+    unsigned long long nodes = 0;
+    for (const auto& move : moves) {
+        child = position;
+        child.applyMove<Us>(move);
+        nodes += copyMakeWalk<Them>(positions + 1, depth - 1);
+    }
+    return nodes;
+}
+
+template <typename Walk>
+static double bestSeconds(Walk walk, unsigned long long& nodes) {
+    const int RUNS = 5;
+    double best = 0;
+    for (int run = 0; run < RUNS; ++run) {
+        auto start = std::chrono::steady_clock::now();
+        nodes = walk();
+        std::chrono::duration<double> elapsed =
+            std::chrono::steady_clock::now() - start;
+        if (run == 0 || elapsed.count() < best) {
+            best = elapsed.count();
+        }
+    }
+    return best;
+}
+
+int main() {
+    const std::vector<std::pair<std::string, int>> POSITIONS = {
+        {"rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1", 5},
+        {"r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+         4},
+        {"8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1", 6},
+        {"r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1", 5},
+    };
+
+    double makeUnmakeTotal = 0;
+    double copyMakeTotal = 0;
+    for (const auto& [fen, depth] : POSITIONS) {
+        Board board;
+        board.loadFEN(fen);
+        const bool white = board.activeColor == WHITE;
+
+        unsigned long long makeUnmakeNodes = 0;
+        unsigned long long copyMakeNodes = 0;
+        double makeUnmakeTime = bestSeconds(
+            [&] {
+                return white ? makeUnmakeWalk<WHITE>(board, depth)
+                             : makeUnmakeWalk<BLACK>(board, depth);
+            },
+            makeUnmakeNodes);
+        double copyMakeTime = bestSeconds(
+            [&] {
+                Position positions[MAX_DEPTH + 1];
+                positions[0] = board;
+                return white ? copyMakeWalk<WHITE>(positions, depth)
+                             : copyMakeWalk<BLACK>(positions, depth);
+            },
+            copyMakeNodes);
+        if (makeUnmakeNodes != copyMakeNodes) {
+            std::cerr << "Node counts differ for " << fen << std::endl;
+            return 1;
+        }
+        makeUnmakeTotal += makeUnmakeTime;
+        copyMakeTotal += copyMakeTime;
+
+        std::cout << fen << " depth " << depth << ": " << makeUnmakeNodes
+                  << " nodes, make/unmake " << makeUnmakeTime * 1000
+                  << " ms, copy-make " << copyMakeTime * 1000 << " ms"
+                  << std::endl;
+    }
+    std::cout << "Total: make/unmake " << makeUnmakeTotal * 1000
+              << " ms, copy-make " << copyMakeTotal * 1000 << " ms, speedup "
+              << makeUnmakeTotal / copyMakeTotal << "x" << std::endl;
+    return 0;
+}
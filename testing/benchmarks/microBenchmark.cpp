@@ -0,0 +1,255 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <string>
+#include <vector>
+#include "../../Board.h"
+#include "../../Evaluation.h"
+#include "../../Minimax.h"
+#include "../../MoveList.h"
+
+// Times the board primitives the search calls at every node, one row per
+// primitive and game phase, in nanoseconds and heap allocations per call:
+//
+//   micro-benchmark [filter]
+//
+// Only primitives whose name contains filter are run. Each row repeats the
+// call over the phase's positions until a batch takes a few milliseconds,
+// then keeps the fastest of several batches.
+
+// Every heap allocation in the binary goes through here
+static std::atomic<size_t> allocationCount{0};
+
+void* operator new(std::size_t size) {
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    if (void* memory = std::malloc(size ? size : 1)) {
+        return memory;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* memory) noexcept {
+    std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept {
+    std::free(memory);
+}
+
+namespace {
+
+struct Phase {
+    const char* name;
+    std::vector<std::string> fens;
+};
+
+const std::vector<Phase> PHASES = {
+    {"opening",
+     {"rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+      "r1bqkbnr/pppp1ppp/2n5/4p3/4P3/5N2/PPPP1PPP/RNBQKB1R w KQkq - 2 3",
+      "rnbqkb1r/pp2pppp/3p1n2/8/3NP3/8/PPP2PPP/RNBQKB1R w KQkq - 1 5"}},
+    {"middlegame",
+     {"r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 10",
+      "r1bq1r1k/1pp1n1pp/1p1p4/4p2Q/4Pp2/1BNP4/PPP2PPP/3R1RK1 w - - 2 14",
+      "3r1rk1/p5pp/bpp1pp2/8/q1PP1P2/b3P3/P2NQRPP/1R2B1K1 b - - 6 22"}},
+    {"endgame",
+     {"8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 11",
+      "6k1/6p1/6Pp/ppp5/3pn2P/1P3K2/1PP2P2/8 b - - 3 54",
+      "8/pp2r1k1/2p1p3/3pP2p/1P1P1P1P/P5KR/8/8 w - - 0 1"}},
+};
+
+// Folded into the output so the compiler cannot drop the measured calls
+unsigned long long checksum = 0;
+
+// Runs op once per board and returns how many calls it made in total
+template <typename Op>
+unsigned long long runBatch(std::vector<Board>& boards, long reps, Op& op) {
+    unsigned long long calls = 0;
+    for (long rep = 0; rep < reps; ++rep) {
+        for (size_t i = 0; i < boards.size(); ++i) {
+            calls += op(boards[i], i);
+        }
+    }
+    return calls;
+}
+
+template <typename Op>
+void measure(const std::string& primitive,
+             const std::string& filter,
+             const Phase& phase,
+             Op op) {
+    if (primitive.find(filter) == std::string::npos) {
+        return;
+    }
+    std::vector<Board> boards(phase.fens.size());
+    for (size_t i = 0; i < boards.size(); ++i) {
+        boards[i].loadFEN(phase.fens[i]);
+    }
+
+    // Double the repetitions until a batch is long enough to time, which
+    // also warms the caches
+    using Clock = std::chrono::steady_clock;
+    const std::chrono::duration<double> MIN_BATCH(0.005);
+    long reps = 1;
+    while (true) {
+        auto start = Clock::now();
+        runBatch(boards, reps, op);
+        if (Clock::now() - start >= MIN_BATCH) {
+            break;
+        }
+        reps *= 2;
+    }
+
+    const int BATCHES = 5;
+    double bestNs = 0;
+    double allocations = 0;
+    for (int batch = 0; batch < BATCHES; ++batch) {
+        const size_t allocationsBefore = allocationCount.load();
+        auto start = Clock::now();
+        const unsigned long long calls = runBatch(boards, reps, op);
+        std::chrono::duration<double, std::nano> elapsed =
+            Clock::now() - start;
+        const double ns = elapsed.count() / calls;
+        if (batch == 0 || ns < bestNs) {
+            bestNs = ns;
+        }
+        allocations = double(allocationCount.load() - allocationsBefore) /
+                      calls;
+    }
+
+    std::cout << std::left << std::setw(28) << primitive << std::setw(12)
+              << phase.name << std::right << std::fixed << std::setw(10)
+              << std::setprecision(1) << bestNs << std::setw(12)
+              << std::setprecision(2) << allocations << std::endl;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    const std::string filter = argc > 1 ? argv[1] : "";
+
+    std::cout << std::left << std::setw(28) << "primitive" << std::setw(12)
+              << "phase" << std::right << std::setw(10) << "ns/op"
+              << std::setw(12) << "allocs/op" << std::endl;
+    for (const Phase& phase : PHASES) {
+        // Every legal move of the position, played and taken back. The
+        // lists are generated up front so only the pair is timed.
+        std::vector<MoveList> legalMoves(phase.fens.size());
+        for (size_t i = 0; i < phase.fens.size(); ++i) {
+            Board board;
+            board.loadFEN(phase.fens[i]);
+            board.generateAllMoves(board.activeColor, true, legalMoves[i]);
+        }
+        measure("makeMove+unmakeMove", filter, phase,
+                [&legalMoves](Board& board, size_t i) {
+                    for (const auto& move : legalMoves[i]) {
+                        board.makeMove(move);
+                        checksum += board.key;
+                        board.unmakeMove(move);
+                    }
+                    return legalMoves[i].size();
+                });
+        // The same moves played the way the search does it: each on a
+        // fresh copy of the position, so there is nothing to take back
+        measure("copy+applyMove", filter, phase,
+                [&legalMoves](Board& board, size_t i) {
+                    Position child;
+                    for (const auto& move : legalMoves[i]) {
+                        child = board;
+                        if (board.activeColor == WHITE) {
+                            child.applyMove<WHITE>(move);
+                        } else {
+                            child.applyMove<BLACK>(move);
+                        }
+                        checksum += child.key;
+                    }
+                    return legalMoves[i].size();
+                });
+        measure("generateAllMoves legal", filter, phase,
+                [](Board& board, size_t) {
+                    MoveList moves;
+                    board.generateAllMoves(board.activeColor, true, moves);
+                    checksum += moves.size();
+                    return 1;
+                });
+        measure("generateAllMoves pseudo", filter, phase,
+                [](Board& board, size_t) {
+                    MoveList moves;
+                    board.generateAllMoves(board.activeColor, false, moves);
+                    checksum += moves.size();
+                    return 1;
+                });
+        measure("countLegalMoves", filter, phase, [](Board& board, size_t) {
+            checksum += board.countLegalMoves(board.activeColor);
+            return 1;
+        });
+        measure("isKingInCheck", filter, phase, [](Board& board, size_t) {
+            checksum += board.isKingInCheck(board.activeColor);
+            return 1;
+        });
+        measure("Minimax::evaluateBoard", filter, phase,
+                [](Board& board, size_t) {
+                    checksum += Minimax::evaluateBoard(board,
+                                                       board.activeColor);
+                    return 1;
+                });
+        // Every child of the position scored one call at a time and then
+        // in batches on each kernel the CPU has
+        std::vector<std::vector<Position>> children(phase.fens.size());
+        std::vector<int> scores;
+        for (size_t i = 0; i < phase.fens.size(); ++i) {
+            Board board;
+            board.loadFEN(phase.fens[i]);
+            for (const auto& move : legalMoves[i]) {
+                Position& child = children[i].emplace_back(board);
+                if (board.activeColor == WHITE) {
+                    child.applyMove<WHITE>(move);
+                } else {
+                    child.applyMove<BLACK>(move);
+                }
+            }
+            scores.resize(std::max(scores.size(), children[i].size()));
+        }
+        measure("Evaluation::evaluate", filter, phase,
+                [&children](Board&, size_t i) {
+                    for (const auto& child : children[i]) {
+                        checksum += Evaluation::evaluate(child);
+                    }
+                    return children[i].size();
+                });
+        const Evaluation::Kernel bestKernel = Evaluation::kernel();
+        const std::pair<Evaluation::Kernel, const char*> KERNELS[] = {
+            {Evaluation::SCALAR, "evaluateBatch scalar"},
+            {Evaluation::AVX2, "evaluateBatch avx2"},
+            {Evaluation::AVX512, "evaluateBatch avx512"},
+        };
+        for (const auto& [kernel, name] : KERNELS) {
+            if (!Evaluation::setKernel(kernel)) {
+                continue;
+            }
+            measure(name, filter, phase,
+                    [&children, &scores](Board&, size_t i) {
+                        Evaluation::evaluateBatch(children[i], scores);
+                        checksum += scores[0];
+                        return children[i].size();
+                    });
+        }
+        Evaluation::setKernel(bestKernel);
+        measure("loadFEN", filter, phase,
+                [&phase](Board& board, size_t i) {
+                    board.loadFEN(phase.fens[i]);
+                    checksum += board.key;
+                    return 1;
+                });
+        measure("toFEN", filter, phase, [](Board& board, size_t) {
+            checksum += board.toFEN().size();
+            return 1;
+        });
+    }
+    std::cout << "checksum " << checksum << std::endl;
+    return 0;
+}
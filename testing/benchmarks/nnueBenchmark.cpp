@@ -0,0 +1,173 @@
+#include <chrono>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "../../Board.h"
+#include "../../MoveList.h"
+#include "../../Nnue.h"
+#include "../../Position.h"
+#include "../RandomNetwork.h"
+
+// Evaluation throughput of the network on each kernel the CPU supports,
+// next to the piece-square evaluation it replaces:
+//
+//   nnue-benchmark [network file]
+//
+// Without a file a random network is written to the temp directory; the
+// speed does not depend on the weights. Each row runs over every child of
+// a handful of positions: "evaluate" reads a ready accumulator, "update"
+// also brings it over from the parent the way the search does. Every
+// kernel must produce the same scores as the scalar one.
+
+namespace {
+
+const std::vector<std::string> FENS = {
+    "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+    "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 10",
+    "r1bq1r1k/1pp1n1pp/1p1p4/4p2Q/4Pp2/1BNP4/PPP2PPP/3R1RK1 w - - 2 14",
+    "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 11",
+    "6k1/6p1/6Pp/ppp5/3pn2P/1P3K2/1PP2P2/8 b - - 3 54",
+};
+
+struct Node {
+    Position parent;
+    Nnue::Accumulator parentAccumulator;
+    Position child;
+    Nnue::Accumulator childAccumulator;
+};
+
+const char* kernelName(Nnue::Kernel kernel) {
+    switch (kernel) {
+        case Nnue::AVX2:
+            return "avx2";
+        case Nnue::SSE41:
+            return "sse4.1";
+        default:
+            return "scalar";
+    }
+}
+
+// Runs op over every node until a few hundred milliseconds have passed and
+// returns the calls per second; checksum must come out the same each pass
+template <typename Op>
+double callsPerSecond(std::vector<Node>& nodes, Op op, long long& checksum) {
+    using Clock = std::chrono::steady_clock;
+    const auto start = Clock::now();
+    long long calls = 0;
+    std::chrono::duration<double> elapsed(0);
+    while (elapsed.count() < 0.3) {
+        checksum = 0;
+        for (auto& node : nodes) {
+            checksum += op(node);
+        }
+        calls += nodes.size();
+        elapsed = Clock::now() - start;
+    }
+    return calls / elapsed.count();
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    std::string path;
+    if (argc > 1) {
+        path = argv[1];
+    } else {
+        path = (std::filesystem::temp_directory_path() / "bench-network.bin")
+                   .string();
+        if (!writeRandomNetwork(path, 1)) {
+            std::cerr << "Cannot write " << path << std::endl;
+            return 1;
+        }
+    }
+    if (!Nnue::load(path)) {
+        std::cerr << "Cannot load a network from " << path << std::endl;
+        return 1;
+    }
+
+    std::vector<Node> nodes;
+    for (const auto& fen : FENS) {
+        Board board;
+        board.loadFEN(fen);
+        MoveList moves;
+        board.generateAllMoves(board.activeColor, true, moves);
+        for (const auto& move : moves) {
+            Node node;
+            node.parent = board;
+            Nnue::refresh(node.parent, node.parentAccumulator);
+            node.child = board;
+            if (board.activeColor == WHITE) {
+                node.child.applyMove<WHITE>(move);
+            } else {
+                node.child.applyMove<BLACK>(move);
+            }
+            Nnue::refresh(node.child, node.childAccumulator);
+            nodes.push_back(node);
+        }
+    }
+
+    std::cout << std::left << std::setw(24) << "evaluation" << std::right
+              << std::setw(14) << "evals/s" << std::setw(10) << "speedup"
+              << std::endl;
+    long long checksum = 0;
+    const double classical = callsPerSecond(
+        nodes, [](Node& node) { return node.child.evaluate(); }, checksum);
+    std::cout << std::left << std::setw(24) << "piece-square" << std::right
+              << std::setw(14) << std::fixed << std::setprecision(0)
+              << classical << std::endl;
+
+    double scalarEvaluate = 0;
+    double scalarUpdate = 0;
+    long long expectedEvaluate = 0;
+    long long expectedUpdate = 0;
+    for (Nnue::Kernel kernel : {Nnue::SCALAR, Nnue::SSE41, Nnue::AVX2}) {
+        if (!Nnue::setKernel(kernel)) {
+            continue;
+        }
+        long long evaluateSum = 0;
+        const double evaluate = callsPerSecond(
+            nodes,
+            [](Node& node) {
+                return Nnue::evaluate(node.childAccumulator,
+                                      node.child.activeColor);
+            },
+            evaluateSum);
+        long long updateSum = 0;
+        const double update = callsPerSecond(
+            nodes,
+            [](Node& node) {
+                Nnue::update(node.parent, node.parentAccumulator, node.child,
+                             node.childAccumulator);
+                return Nnue::evaluate(node.childAccumulator,
+                                      node.child.activeColor);
+            },
+            updateSum);
+        if (kernel == Nnue::SCALAR) {
+            scalarEvaluate = evaluate;
+            scalarUpdate = update;
+            expectedEvaluate = evaluateSum;
+            expectedUpdate = updateSum;
+        } else if (evaluateSum != expectedEvaluate ||
+                   updateSum != expectedUpdate) {
+            std::cerr << kernelName(kernel) << " disagrees with scalar"
+                      << std::endl;
+            return 1;
+        }
+
+        std::cout << std::left << std::setw(24)
+                  << (std::string("evaluate ") + kernelName(kernel))
+                  << std::right << std::setw(14) << std::setprecision(0)
+                  << evaluate << std::setw(9) << std::setprecision(2)
+                  << evaluate / scalarEvaluate << "x" << std::endl;
+        std::cout << std::left << std::setw(24)
+                  << (std::string("update+evaluate ") + kernelName(kernel))
+                  << std::right << std::setw(14) << std::setprecision(0)
+                  << update << std::setw(9) << std::setprecision(2)
+                  << update / scalarUpdate << "x" << std::endl;
+    }
+    std::cout << nodes.size() << " positions, checksum " << expectedEvaluate
+              << std::endl;
+    return 0;
+}
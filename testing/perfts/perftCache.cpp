@@ -0,0 +1,57 @@
+#include "perftCache.h"
+#include <algorithm>
+
+PerftCache::PerftCache(size_t megabytes) {
+    resize(megabytes);
+}
+
+void PerftCache::resize(size_t megabytes) {
+    size_t count = 1;
+    const size_t wanted = std::max<size_t>(megabytes, 1) * 1024 * 1024 /
+                          sizeof(Bucket);
+    while (count * 2 <= wanted) {
+        count *= 2;
+    }
+    buckets = std::vector<Bucket>(count);
+}
+
+void PerftCache::clear() {
+    for (auto& bucket : buckets) {
+        for (auto& entry : bucket.entries) {
+            entry.check.store(0, std::memory_order_relaxed);
+            entry.data.store(0, std::memory_order_relaxed);
+        }
+    }
+}
+
+bool PerftCache::probe(uint64_t key, int depth, unsigned long long& nodes) {
+    for (const auto& entry : bucketFor(key, depth).entries) {
+        const uint64_t data = entry.data.load(std::memory_order_relaxed);
+        const uint64_t check = entry.check.load(std::memory_order_relaxed);
+        if ((data & 0xFF) == static_cast<uint64_t>(depth) &&
+            (check ^ data) == key) {
+            nodes = data >> 8;
+            return true;
+        }
+    }
+    return false;
+}
+
+void PerftCache::store(uint64_t key, int depth, unsigned long long nodes) {
+    const uint64_t data = (nodes << 8) | static_cast<uint64_t>(depth);
+    Entry* entries = bucketFor(key, depth).entries;
+    Entry* victim = &entries[0];
+    for (int i = 0; i < 4; ++i) {
+        const uint64_t stored = entries[i].data.load(std::memory_order_relaxed);
+        if (stored == 0) {
+            victim = &entries[i];
+            break;
+        }
+        if ((stored & 0xFF) <
+            (victim->data.load(std::memory_order_relaxed) & 0xFF)) {
+            victim = &entries[i];
+        }
+    }
+    victim->check.store(key ^ data, std::memory_order_relaxed);
+    victim->data.store(data, std::memory_order_relaxed);
+}
@@ -0,0 +1,55 @@
+#ifndef PERFTCACHE_H
+#define PERFTCACHE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Subtree node counts keyed by (Zobrist key, depth), so a position reached
+// by several move orders is only walked once. Buckets are one cache line
+// of four entries; a full bucket gives up its shallowest subtree, the
+// cheapest to count again.
+//
+// Entries are written without locks. Each stores key ^ data next to data,
+// so a torn write from another thread reads back as a miss rather than as
+// a wrong count. Callers keep their own Stats for the same reason: shared
+// counters would serialize every probe.
+class PerftCache {
+   public:
+    static const size_t DEFAULT_MB = 64;
+
+    struct Stats {
+        unsigned long long probes = 0;
+        unsigned long long hits = 0;
+    };
+
+    explicit PerftCache(size_t megabytes = DEFAULT_MB);
+
+    // Rounds down to a power-of-two number of buckets and clears the cache.
+    void resize(size_t megabytes);
+    void clear();
+
+    bool probe(uint64_t key, int depth, unsigned long long& nodes);
+    void store(uint64_t key, int depth, unsigned long long nodes);
+
+    size_t bucketCount() const { return buckets.size(); }
+
+   private:
+    struct Entry {
+        std::atomic<uint64_t> check;  // key ^ data
+        std::atomic<uint64_t> data;   // nodes << 8 | depth
+    };
+    struct alignas(64) Bucket {
+        Entry entries[4];
+    };
+
+    Bucket& bucketFor(uint64_t key, int depth) {
+        return buckets[(key ^ (depth * 0x9E3779B97F4A7C15ULL)) &
+                       (buckets.size() - 1)];
+    }
+
+    std::vector<Bucket> buckets;
+};
+
+#endif  // PERFTCACHE_H
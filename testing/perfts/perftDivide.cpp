@@ -0,0 +1,344 @@
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "../../Board.h"
+#include "../../MoveList.h"
+
+// Command-line perft for tracking down move generator bugs:
+//
+//   perft [--fen FEN] [--depth N] [--divide] [--stats] [--json]
+//
+// --divide prints the subtree under every root move, in UCI notation, so a
+// count can be compared move by move against another engine. --stats adds
+// the usual captures / e.p. / castles / promotions / checks / checkmates
+// columns; it has to play every leaf move, so its nodes per second are not
+// comparable with a plain run, which counts the last ply without playing it.
+
+namespace {
+
+const char* START_FEN =
+    "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1";
+
+// Counted for the moves of the last ply, like the published perft tables
+struct PerftStats {
+    unsigned long long nodes = 0;
+    unsigned long long captures = 0;
+    unsigned long long enPassants = 0;
+    unsigned long long castles = 0;
+    unsigned long long promotions = 0;
+    unsigned long long checks = 0;
+    unsigned long long checkmates = 0;
+
+    PerftStats& operator+=(const PerftStats& other) {
+        nodes += other.nodes;
+        captures += other.captures;
+        enPassants += other.enPassants;
+        castles += other.castles;
+        promotions += other.promotions;
+        checks += other.checks;
+        checkmates += other.checkmates;
+        return *this;
+    }
+};
+
+struct Options {
+    std::string fen = START_FEN;
+    int depth = 5;
+    bool divide = false;
+    bool stats = false;
+    bool json = false;
+};
+
+unsigned long long countNodes(Board& board, int depth) {
+    if (depth == 0) {
+        return 1;
+    }
+    if (depth == 1) {
+        return board.countLegalMoves(board.activeColor);
+    }
+
+    MoveList moves;
+    board.generateAllMoves(board.activeColor, true, moves);
+    unsigned long long nodes = 0;
+    for (const auto& move : moves) {
+        board.makeMove(move);
+        nodes += countNodes(board, depth - 1);
+        board.unmakeMove(move);
+    }
+    return nodes;
+}
+
+// Classifies move, which has to be the move just played to reach board
+void addLeaf(Board& board, const Move& move, bool captured, PerftStats& stats) {
+    ++stats.nodes;
+    stats.captures += captured || move.type() == EN_PASSANT;
+    stats.enPassants += move.type() == EN_PASSANT;
+    stats.castles += move.type() == CASTLING;
+    stats.promotions += move.type() == PROMOTION;
+    if (board.isKingInCheck(board.activeColor)) {
+        ++stats.checks;
+        stats.checkmates += board.countLegalMoves(board.activeColor) == 0;
+    }
+}
+
+PerftStats collectStats(Board& board, int depth) {
+    PerftStats stats;
+    if (depth == 0) {
+        stats.nodes = 1;
+        return stats;
+    }
+
+    MoveList moves;
+    board.generateAllMoves(board.activeColor, true, moves);
+    for (const auto& move : moves) {
+        const bool captured = board.pieceOn(move.to()) != NO_PIECE;
+        board.makeMove(move);
+        if (depth == 1) {
+            addLeaf(board, move, captured, stats);
+        } else {
+            stats += collectStats(board, depth - 1);
+        }
+        board.unmakeMove(move);
+    }
+    return stats;
+}
+
+// The subtree below move, which has just been played. At depth 1 the move
+// is itself the leaf.
+PerftStats subtree(Board& board,
+                   const Move& move,
+                   bool captured,
+                   int depth,
+                   bool withStats) {
+    PerftStats stats;
+    if (!withStats) {
+        stats.nodes = countNodes(board, depth - 1);
+    } else if (depth == 1) {
+        addLeaf(board, move, captured, stats);
+    } else {
+        stats = collectStats(board, depth - 1);
+    }
+    return stats;
+}
+
+std::string jsonEscape(const std::string& text) {
+    std::string escaped;
+    for (char c : text) {
+        if (c == '"' || c == '\\') {
+            escaped += '\\';
+        }
+        escaped += c;
+    }
+    return escaped;
+}
+
+std::string statsText(const PerftStats& stats, bool withStats) {
+    std::ostringstream text;
+    text << stats.nodes;
+    if (withStats) {
+        text << "  captures " << stats.captures << "  e.p. "
+             << stats.enPassants << "  castles " << stats.castles
+             << "  promotions " << stats.promotions << "  checks "
+             << stats.checks << "  checkmates " << stats.checkmates;
+    }
+    return text.str();
+}
+
+std::string statsJSON(const PerftStats& stats, bool withStats) {
+    std::ostringstream json;
+    json << "\"nodes\": " << stats.nodes;
+    if (withStats) {
+        json << ", \"captures\": " << stats.captures
+             << ", \"enPassants\": " << stats.enPassants
+             << ", \"castles\": " << stats.castles
+             << ", \"promotions\": " << stats.promotions
+             << ", \"checks\": " << stats.checks
+             << ", \"checkmates\": " << stats.checkmates;
+    }
+    return json.str();
+}
+
+// Board::loadFEN trusts its input, and a bad board field sends squares off
+// the board, so the FEN is checked before it gets there. The halfmove
+// clock and fullmove number may be left out; loadFEN defaults them.
+bool validateFEN(const std::string& fen, std::string& error) {
+    // Split the way loadFEN does, on single spaces
+    std::vector<std::string> fields;
+    std::istringstream stream(fen);
+    std::string field;
+    while (std::getline(stream, field, ' ')) {
+        fields.push_back(field);
+    }
+    if (fields.size() < 4 || fields.size() > 6) {
+        error = "expected 4 to 6 fields separated by single spaces";
+        return false;
+    }
+
+    int ranks = 1;
+    int files = 0;
+    int kings[2] = {0, 0};
+    for (char c : fields[0]) {
+        if (c == '/') {
+            if (files != 8) {
+                error = "rank " + std::to_string(9 - ranks) +
+                        " does not have 8 squares";
+                return false;
+            }
+            ++ranks;
+            files = 0;
+        } else if (c >= '1' && c <= '8') {
+            files += c - '0';
+        } else if (pieceFromSymbol(c) != NO_PIECE) {
+            ++files;
+            if (pieceType(pieceFromSymbol(c)) == KING) {
+                ++kings[pieceColor(pieceFromSymbol(c))];
+            }
+        } else {
+            error = std::string("unknown piece '") + c + "'";
+            return false;
+        }
+        if (files > 8) {
+            error = "rank " + std::to_string(9 - ranks) +
+                    " has more than 8 squares";
+            return false;
+        }
+    }
+    if (ranks != 8 || files != 8) {
+        error = "the board needs 8 ranks of 8 squares";
+        return false;
+    }
+    if (kings[WHITE] != 1 || kings[BLACK] != 1) {
+        error = "each side needs exactly one king";
+        return false;
+    }
+
+    if (fields[1] != "w" && fields[1] != "b") {
+        error = "the side to move must be w or b";
+        return false;
+    }
+    if (fields[2] != "-" &&
+        fields[2].find_first_not_of("KQkq") != std::string::npos) {
+        error = "castling rights must be - or letters of KQkq";
+        return false;
+    }
+    if (fields[3] != "-" &&
+        (fields[3].size() != 2 || fields[3][0] < 'a' || fields[3][0] > 'h' ||
+         (fields[3][1] != '3' && fields[3][1] != '6'))) {
+        error = "the en passant square must be - or on rank 3 or 6";
+        return false;
+    }
+    for (size_t i = 4; i < fields.size(); ++i) {
+        if (fields[i].empty() || fields[i].size() > 5 ||
+            fields[i].find_first_not_of("0123456789") != std::string::npos) {
+            error = "the move counters must be numbers";
+            return false;
+        }
+    }
+    return true;
+}
+
+void printUsage() {
+    std::cerr << "usage: perft [--fen FEN] [--depth N] [--divide] [--stats] "
+                 "[--json]"
+              << std::endl;
+}
+
+bool parseOptions(int argc, char* argv[], Options& options) {
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "--fen" && i + 1 < argc) {
+            options.fen = argv[++i];
+        } else if (arg == "--depth" && i + 1 < argc) {
+            char* end;
+            options.depth = std::strtol(argv[++i], &end, 10);
+            if (*end != '\0' || options.depth < 1) {
+                std::cerr << "--depth must be a positive integer" << std::endl;
+                return false;
+            }
+        } else if (arg == "--divide") {
+            options.divide = true;
+        } else if (arg == "--stats") {
+            options.stats = true;
+        } else if (arg == "--json") {
+            options.json = true;
+        } else {
+            std::cerr << "unknown or incomplete option " << arg << std::endl;
+            return false;
+        }
+    }
+
+    std::string error;
+    if (!validateFEN(options.fen, error)) {
+        std::cerr << "invalid FEN: " << error << std::endl;
+        return false;
+    }
+    return true;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    Options options;
+    if (!parseOptions(argc, argv, options)) {
+        printUsage();
+        return 1;
+    }
+
+    Board board;
+    board.loadFEN(options.fen);
+
+    auto start = std::chrono::steady_clock::now();
+    MoveList moves;
+    board.generateAllMoves(board.activeColor, true, moves);
+    std::vector<PerftStats> divided;
+    PerftStats total;
+    for (const auto& move : moves) {
+        const bool captured = board.pieceOn(move.to()) != NO_PIECE;
+        board.makeMove(move);
+        divided.push_back(
+            subtree(board, move, captured, options.depth, options.stats));
+        board.unmakeMove(move);
+        total += divided.back();
+    }
+    std::chrono::duration<double> elapsed =
+        std::chrono::steady_clock::now() - start;
+    const double seconds = elapsed.count();
+    const unsigned long long nps =
+        seconds > 0 ? static_cast<unsigned long long>(total.nodes / seconds)
+                    : 0;
+
+    if (options.json) {
+        std::cout << "{\"fen\": \"" << jsonEscape(options.fen)
+                  << "\", \"depth\": " << options.depth << ", "
+                  << statsJSON(total, options.stats)
+                  << ", \"timeMs\": " << seconds * 1000
+                  << ", \"nps\": " << nps;
+        if (options.divide) {
+            std::cout << ", \"divide\": [";
+            for (int i = 0; i < moves.size(); ++i) {
+                std::cout << (i ? ", " : "") << "{\"move\": \""
+                          << moves[i].toUCI() << "\", "
+                          << statsJSON(divided[i], options.stats) << "}";
+            }
+            std::cout << "]";
+        }
+        std::cout << "}" << std::endl;
+        return 0;
+    }
+
+    if (options.divide) {
+        for (int i = 0; i < moves.size(); ++i) {
+            std::cout << moves[i].toUCI() << ": "
+                      << statsText(divided[i], options.stats) << std::endl;
+        }
+        std::cout << std::endl;
+    }
+    std::cout << "Moves: " << moves.size() << std::endl;
+    std::cout << "Nodes: " << statsText(total, options.stats) << std::endl;
+    std::cout << "Time: " << seconds * 1000 << " ms (" << nps << " nodes/s)"
+              << std::endl;
+    return 0;
+}
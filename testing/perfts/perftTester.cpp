@@ -1,11 +1,16 @@
 #include "perftTester.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <fstream>
 #include <iostream>
 #include <sstream>
 #include <string>
 #include <vector>
+#include "../../ThreadPool.h"
+#include "catch2/catch_test_macros.hpp"
 
-const int MAX_NODES_PER_TEST = 10000;
+extern const unsigned long long MAX_NODES_PER_TEST = 1000000;
 
 // Function to read the contents of a file
 std::string readFile(const std::string& filename) {
@@ -33,33 +38,99 @@ std::vector<std::string> parseFileContents(const std::string& contents) {
     return lines;
 }
 
-std::pair<std::string, std::vector<int>> parsePerftTest(
-    const std::string& line) {
-    // std::cout << "Parsing perft test: " << line << std::endl;
+// Parses "<fen> ;D1 20 ;D2 400" into the FEN and (depth, nodes) pairs. The
+// depth comes from the label, since some suites only list deep entries.
+std::pair<std::string, std::vector<std::pair<int, unsigned long long>>>
+parsePerftTest(const std::string& line, unsigned long long maxNodes) {
     std::stringstream ss(line);
     std::string fen;
-    std::vector<int> nodesAtDepth;
+    std::vector<std::pair<int, unsigned long long>> nodesAtDepth;
     std::getline(ss, fen, ';');
     std::string depthStr;
     while (std::getline(ss, depthStr, ';')) {
-        // std::cout << "Parsing depth: " << depthStr << std::endl;
         std::stringstream depthStream(depthStr);
         std::string depthLabel;
-        int nodes;
-        depthStream >> depthLabel >> nodes;
-        // std::cout << "Parsed depth: " << depthLabel << " " << nodes
-        // << std::endl;
-        if (nodes > MAX_NODES_PER_TEST) {
+        unsigned long long nodes;
+        if (!(depthStream >> depthLabel >> nodes) || depthLabel.size() < 2) {
+            continue;
+        }
+        if (nodes > maxNodes) {
             break;
         }
-        nodesAtDepth.push_back(nodes);
+        nodesAtDepth.push_back({std::stoi(depthLabel.substr(1)), nodes});
     }
-    // std::cout << "Parsed perft test: " << fen << std::endl;
     return {fen, nodesAtDepth};
 }
 
+int perftThreads = 0;
+
+namespace {
+
+// One suite entry at one depth, checked once all of its subtrees are in
+struct PerftCheck {
+    size_t testCase;
+    int depth;
+    unsigned long long expected;
+};
+
+// One subtree of a check: the position after playing path from the
+// entry's FEN, walked to the remaining depth
+struct PerftTask {
+    size_t check;
+    Move path[2];
+    int pathLength;
+    double estimate;  // share of the expected nodes, to start big ones first
+};
+
+// Written only by the worker that owns it, and padded so neighbours do not
+// share a cache line
+struct alignas(64) ThreadTotals {
+    unsigned long long nodes = 0;
+    PerftCache::Stats cacheStats;
+};
+
+// Shallow checks stay whole. Deeper ones split at the root, and a ply
+// further when there are too few root moves to keep every thread busy.
+void splitCheck(const std::string& fen,
+                size_t index,
+                const PerftCheck& check,
+                int threads,
+                std::vector<PerftTask>& tasks) {
+    if (check.depth < 3) {
+        tasks.push_back({index, {}, 0, double(check.expected)});
+        return;
+    }
+
+    Board board;
+    board.loadFEN(fen);
+    MoveList rootMoves;
+    board.generateAllMoves(board.activeColor, true, rootMoves);
+    const bool splitTwice =
+        check.depth >= 4 && rootMoves.size() < 4 * threads;
+    const size_t first = tasks.size();
+    for (const auto& move : rootMoves) {
+        if (!splitTwice) {
+            tasks.push_back({index, {move}, 1, 0});
+            continue;
+        }
+        board.makeMove(move);
+        MoveList replies;
+        board.generateAllMoves(board.activeColor, true, replies);
+        for (const auto& reply : replies) {
+            tasks.push_back({index, {move, reply}, 2, 0});
+        }
+        board.unmakeMove(move);
+    }
+    for (size_t i = first; i < tasks.size(); ++i) {
+        tasks[i].estimate = double(check.expected) / (tasks.size() - first);
+    }
+}
+
+}  // namespace
+
 // Function to run perft tests on the board
-bool runPerftTests(const std::vector<std::string>& testCases) {
+bool runPerftTests(const std::vector<std::string>& testCases,
+                   PerftCache* cache) {
     bool failed = false;
     std::ofstream failedFile("testing/perfts/failedPerfts.txt",
                              std::ios::out | std::ios::app);
@@ -68,35 +139,102 @@ bool runPerftTests(const std::vector<std::string>& testCases) {
                   << std::endl;
         return false;
     }
-    std::cout << "Running perft tests... in thingy" << std::endl;
-    for (const auto& testCase : testCases) {
-        std::cout << "Running perft test: " << testCase << std::endl;
-        auto [fen, nodesAtDepth] = parsePerftTest(testCase);
-        // std::cout << "Running perft tests... " << fen << std::endl;
-        for (int depth = 1; depth <= nodesAtDepth.size(); ++depth) {
-            // std::cout << "Running test for depth " << depth << std::endl;
+
+    ThreadPool pool(perftThreads);
+    const auto start = std::chrono::steady_clock::now();
+
+    // Every depth of every entry is split into subtrees up front, so
+    // separate FENs run side by side and the pool stays full to the end
+    std::vector<std::string> fens(testCases.size());
+    std::vector<PerftCheck> checks;
+    std::vector<PerftTask> tasks;
+    for (size_t i = 0; i < testCases.size(); ++i) {
+        if (testCases[i].empty()) {
+            continue;
+        }
+        auto [fen, nodesAtDepth] = parsePerftTest(
+            testCases[i], cache ? ~0ULL : MAX_NODES_PER_TEST);
+        fens[i] = fen;
+        for (const auto& [depth, expected] : nodesAtDepth) {
+            checks.push_back({i, depth, expected});
+            splitCheck(fen, checks.size() - 1, checks.back(), pool.size(),
+                       tasks);
+        }
+    }
+    std::sort(tasks.begin(), tasks.end(),
+              [](const PerftTask& a, const PerftTask& b) {
+                  return a.estimate > b.estimate;
+              });
+    std::cout << "Running " << checks.size() << " perft checks as "
+              << tasks.size() << " tasks on " << pool.size() << " threads..."
+              << std::endl;
+
+    std::vector<std::atomic<unsigned long long>> counts(checks.size());
+    std::vector<ThreadTotals> totals(pool.size());
+    for (const auto& task : tasks) {
+        pool.submit([&, task](int worker) {
+            const PerftCheck& check = checks[task.check];
             Board board;
-            board.loadFEN(fen);
-            // std::cout << "Loaded FEN" << std::endl;
-            unsigned long long nodes = perft(&board, depth, board.activeColor);
-            // std::cout << "Got nodes: " << nodes << std::endl;
-            if (nodes != nodesAtDepth[depth - 1]) {
-                std::cerr << "Perft test failed for FEN: " << fen
-                          << " at depth " << depth << std::endl;
-                std::cerr << "Expected: " << nodesAtDepth[depth - 1]
-                          << " nodes, got: " << nodes << " nodes" << std::endl;
-                failedFile << testCase << std::endl;
-                failed = true;
-                break;
+            board.loadFEN(fens[check.testCase]);
+            for (int i = 0; i < task.pathLength; ++i) {
+                board.makeMove(task.path[i]);
             }
+            const int depth = check.depth - task.pathLength;
+            const unsigned long long nodes =
+                cache ? hashedPerft(board, depth, *cache,
+                                    totals[worker].cacheStats)
+                      : perft(&board, depth, board.activeColor);
+            counts[task.check].fetch_add(nodes, std::memory_order_relaxed);
+            totals[worker].nodes += nodes;
+        });
+    }
+    pool.wait();
+
+    size_t lastFailedCase = testCases.size();
+    for (size_t i = 0; i < checks.size(); ++i) {
+        const PerftCheck& check = checks[i];
+        if (counts[i] == check.expected) {
+            continue;
         }
+        std::cerr << "Perft test failed for FEN: " << fens[check.testCase]
+                  << " at depth " << check.depth << std::endl;
+        std::cerr << "Expected: " << check.expected << " nodes, got: "
+                  << counts[i] << " nodes" << std::endl;
+        if (check.testCase != lastFailedCase) {
+            failedFile << testCases[check.testCase] << std::endl;
+            lastFailedCase = check.testCase;
+        }
+        failed = true;
+    }
+
+    const std::chrono::duration<double> elapsed =
+        std::chrono::steady_clock::now() - start;
+    unsigned long long totalNodes = 0;
+    PerftCache::Stats cacheStats;
+    for (int i = 0; i < pool.size(); ++i) {
+        std::cout << "Thread " << i << ": " << totals[i].nodes << " nodes"
+                  << std::endl;
+        totalNodes += totals[i].nodes;
+        cacheStats.probes += totals[i].cacheStats.probes;
+        cacheStats.hits += totals[i].cacheStats.hits;
+    }
+    std::cout << totalNodes << " nodes in " << elapsed.count() << "s ("
+              << static_cast<unsigned long long>(totalNodes /
+                                                 elapsed.count())
+              << " nodes/s)";
+    if (cache) {
+        std::cout << ", cache hit rate "
+                  << (cacheStats.probes
+                          ? 100.0 * cacheStats.hits / cacheStats.probes
+                          : 0.0)
+                  << "%";
     }
+    std::cout << std::endl;
 
     if (!failed) {
         std::cout << "All perft tests passed!" << std::endl;
     }
 
-    // failedFile.close();
     return !failed;
 }
 
@@ -104,50 +242,99 @@ unsigned long long perft(Board* board, int depth, Color color) {
     if (depth == 0) {
         return 1;
     }
+    if (depth == 1) {
+        return board->countLegalMoves(color);
+    }
 
     unsigned long long nodes = 0;
-    // std::cout << "Generating moves for depth " << depth << " and color "
-    //           << (color == WHITE ? "WHITE" : "BLACK") << std::endl;
-    // board->display();
-    auto moves = board->generateAllMoves(color, true);
-    // std::cout << "Generated moves for depth " << depth << std::endl;
+    MoveList moves;
+    board->generateAllMoves(color, true, moves);
     for (const auto& move : moves) {
-        // std::cout << "Making move for depth " << depth << std::endl;
-        // if (depth == 4) {
-        //     board->display();
-        //     std::cout << "before move: " << board->toFEN() << std::endl;
-        // }
         board->makeMove(move);
-        // std::cout << "Made move for depth " << depth << std::endl;
-        // if (depth == 4) {
-        //     board->display();
-        //     std::cout << "after move: " << board->toFEN() << std::endl;
-        // }
         nodes += perft(board, depth - 1, color == WHITE ? BLACK : WHITE);
-        // std::cout << "Unmaking move for depth " << depth << std::endl;
         board->unmakeMove(move);
-        // std::cout << "Unmade move for depth " << depth << std::endl;
     }
     return nodes;
 }
 
-bool runPerftTests() {
-    // return runPerftTests(
-    //     {"r3k2r/8/8/8/8/8/8/R3K2R w KQkq - 0 1 ;D1 26 ;D2 568 ;D3 13744 ;D4 "
-    //      "314346 ;D5 7594526 ;D6 179862938"});
-    // Read the contents of the three text files
-    // std::vector<std::string> filesToRead = {"customPerfts.txt"};
-    std::vector<std::string> filesToRead = {
-        "basicPerfts.txt", "complexPerfts.txt", "specialMovesPerfts.txt",
-        "customPerfts.txt"};
-    std::vector<std::string> allTestCases;
+unsigned long long hashedPerft(Board& board,
+                               int depth,
+                               PerftCache& cache,
+                               PerftCache::Stats& stats) {
+    if (depth == 0) {
+        return 1;
+    }
+
+    unsigned long long nodes = 0;
+    if (depth >= 2) {
+        ++stats.probes;
+        if (cache.probe(board.key, depth, nodes)) {
+            ++stats.hits;
+            return nodes;
+        }
+    }
+    if (depth == 1) {
+        return board.countLegalMoves(board.activeColor);
+    }
+    MoveList moves;
+    board.generateAllMoves(board.activeColor, true, moves);
+    for (const auto& move : moves) {
+        board.makeMove(move);
+        nodes += hashedPerft(board, depth - 1, cache, stats);
+        board.unmakeMove(move);
+    }
+    cache.store(board.key, depth, nodes);
+    return nodes;
+}
 
-    for (const auto& file : filesToRead) {
+std::vector<std::string> readPerftSuites(
+    const std::vector<std::string>& files) {
+    std::vector<std::string> allTestCases;
+    for (const auto& file : files) {
         std::string fileContents = readFile(file);
         std::vector<std::string> testCases = parseFileContents(fileContents);
         allTestCases.insert(allTestCases.end(), testCases.begin(),
                             testCases.end());
     }
+    return allTestCases;
+}
+
+bool runPerftTests() {
+    return runPerftTests(
+        readPerftSuites({"basicPerfts.txt", "complexPerfts.txt",
+                         "specialMovesPerfts.txt", "customPerfts.txt"}));
+}
+
+TEST_CASE("perft suites") {
+    REQUIRE(runPerftTests());
+}
+
+TEST_CASE("hashed perft suites at every listed depth") {
+    PerftCache cache;
+    REQUIRE(runPerftTests(
+        readPerftSuites({"basicPerfts.txt", "specialMovesPerfts.txt"}),
+        &cache));
+}
 
-    return runPerftTests(allTestCases);
-}
\ No newline at end of file
+TEST_CASE("countLegalMoves matches the generated move list") {
+    for (const auto& testCase : readPerftSuites(
+             {"basicPerfts.txt", "complexPerfts.txt", "specialMovesPerfts.txt",
+              "customPerfts.txt"})) {
+        if (testCase.empty()) {
+            continue;
+        }
+        Board board;
+        board.loadFEN(parsePerftTest(testCase).first);
+        MoveList moves;
+        board.generateAllMoves(board.activeColor, true, moves);
+        REQUIRE(board.countLegalMoves(board.activeColor) == moves.size());
+        for (const auto& move : moves) {
+            board.makeMove(move);
+            MoveList replies;
+            board.generateAllMoves(board.activeColor, true, replies);
+            REQUIRE(board.countLegalMoves(board.activeColor) ==
+                    replies.size());
+            board.unmakeMove(move);
+        }
+    }
+}
@@ -4,13 +4,33 @@
 #include <string>
 #include <vector>
 #include "../../Board.h"
+#include "perftCache.h"
 
 std::string readFile(const std::string& filename);
 std::vector<std::string> parseFileContents(const std::string& contents);
-std::pair<std::string, std::vector<int>> parsePerftTest(
-    const std::string& line);
+extern const unsigned long long MAX_NODES_PER_TEST;
+std::pair<std::string, std::vector<std::pair<int, unsigned long long>>>
+parsePerftTest(const std::string& line,
+               unsigned long long maxNodes = MAX_NODES_PER_TEST);
+// Both count the last ply with countLegalMoves instead of playing it.
 unsigned long long perft(Board* board, int depth, Color color);
-bool runPerftTests(const std::vector<std::string>& testCases);
+// Also looks every deeper subtree up in cache before walking it. Probes and
+// hits are added to stats.
+unsigned long long hashedPerft(Board& board,
+                               int depth,
+                               PerftCache& cache,
+                               PerftCache::Stats& stats);
+
+// Worker threads for runPerftTests; 0 uses every hardware thread. The
+// tests binary sets it from --threads.
+extern int perftThreads;
+// Splits every listed depth into subtrees and counts them on a thread
+// pool. Without a cache every depth up to MAX_NODES_PER_TEST is walked in
+// full; with one, every listed depth is checked through hashedPerft.
+bool runPerftTests(const std::vector<std::string>& testCases,
+                   PerftCache* cache = nullptr);
+std::vector<std::string> readPerftSuites(
+    const std::vector<std::string>& files);
 bool runPerftTests();
 
 #endif  // PERFTTESTER_H
\ No newline at end of file
@@ -0,0 +1,19 @@
+#include "catch2/catch_session.hpp"
+#include "perfts/perftTester.h"
+
+// Catch2's own main plus --threads, which sizes the perft thread pool
+int main(int argc, char* argv[]) {
+    Catch::Session session;
+
+    using namespace Catch::Clara;
+    auto cli = session.cli() |
+               Opt(perftThreads, "threads")["--threads"](
+                   "perft worker threads (default: all hardware threads)");
+    session.cli(cli);
+
+    int result = session.applyCommandLine(argc, argv);
+    if (result != 0) {
+        return result;
+    }
+    return session.run();
+}